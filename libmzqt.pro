@@ -1,3 +1,8 @@
+# Monolithic Windows build: the vendor backends are compiled in the library
+# and created directly, not loaded as plugins. The backend plugins
+# (mzqt_thermo, mzqt_masslynx), the mzqtworker program of
+# ProcessPoolReader and the tests are only built by CMake.
+
 TEMPLATE = lib
 DESTDIR = lib
 MOC_DIR = tmp
@@ -5,6 +10,7 @@ OBJECTS_DIR = tmp
 TARGET = mzqt
 CONFIG += qaxcontainer
 CONFIG += warn_on
+CONFIG += c++11 thread
 
 QT -= gui
 
@@ -40,12 +46,37 @@ HEADERS = mzqt/common/UVSpectrum.h \
     mzqt/converters/massWolf/DACFunctionInfo.h \
     mzqt/converters/ReAdW/FilterLine.h \
     mzqt/converters/ReAdW/ThermoInterface.h \
+    mzqt/converters/ReAdW/SrmChromatogramBuilder.h \
     mzqt/converters/massWolf/DACProcessInfo.h \
     mzqt/common/InstrumentInfo.h \
     mzqt/common/InstrumentInterface.h \
+    mzqt/common/InstrumentInterfacePlugin.h \
+    mzqt/common/BackendRegistry.h \
     mzqt/common/MSTypes.h \
     mzqt/common/MSUtilities.h \
+    mzqt/common/MzMatcher.h \
+    mzqt/common/MsxDemultiplexer.h \
+    mzqt/common/PrecursorCorrector.h \
+    mzqt/common/PrefetchReader.h \
+    mzqt/common/ProcessPoolReader.h \
+    mzqt/common/Progress.h \
+    mzqt/common/PrecursorPurity.h \
     mzqt/common/Scan.h \
+    mzqt/common/BlankSubtractor.h \
+    mzqt/common/ConversionCheckpoint.h \
+    mzqt/common/Dataset.h \
+    mzqt/common/ScanMerger.h \
+    mzqt/common/ScanPipeline.h \
+    mzqt/common/ScanRange.h \
+    mzqt/common/ScanCodec.h \
+    mzqt/common/ScanSelection.h \
+    mzqt/common/ScanVisitor.h \
+    mzqt/common/ScanHasher.h \
+    mzqt/common/SpectrumCache.h \
+    mzqt/common/ShmRing.h \
+    mzqt/common/SpectrumValidator.h \
+    mzqt/common/TailFollowReader.h \
+    mzqt/common/SpscRing.h \
     mzqt/common/IDispatch.h \ 
     mzqt/common/Exception.h \
     mzqt/common/Debug.h \
@@ -63,11 +94,32 @@ SOURCES = mzqt/common/UVSpectrum.cpp \
     mzqt/converters/massWolf/DACFunctionInfo.cpp \
     mzqt/converters/ReAdW/FilterLine.cpp \
     mzqt/common/InstrumentInterface.cpp \
+    mzqt/common/BackendRegistry.cpp \
     mzqt/converters/ReAdW/ThermoInterface.cpp \
+    mzqt/converters/ReAdW/SrmChromatogramBuilder.cpp \
     mzqt/converters/massWolf/DACProcessInfo.cpp \
     mzqt/common/MSTypes.cpp \
     mzqt/common/MSUtilities.cpp \
+    mzqt/common/MsxDemultiplexer.cpp \
+    mzqt/common/PrecursorCorrector.cpp \
+    mzqt/common/PrefetchReader.cpp \
+    mzqt/common/ProcessPoolReader.cpp \
+    mzqt/common/Progress.cpp \
+    mzqt/common/PrecursorPurity.cpp \
     mzqt/common/Scan.cpp \
+    mzqt/common/BlankSubtractor.cpp \
+    mzqt/common/ConversionCheckpoint.cpp \
+    mzqt/common/Dataset.cpp \
+    mzqt/common/ScanMerger.cpp \
+    mzqt/common/ScanPipeline.cpp \
+    mzqt/common/ScanCodec.cpp \
+    mzqt/common/ScanSelection.cpp \
+    mzqt/common/ScanVisitor.cpp \
+    mzqt/common/ScanHasher.cpp \
+    mzqt/common/SpectrumCache.cpp \
+    mzqt/common/ShmRing.cpp \
+    mzqt/common/SpectrumValidator.cpp \
+    mzqt/common/TailFollowReader.cpp \
     mzqt/common/IDispatch.cpp \
     mzqt/common/Exception.cpp \
     mzqt/common/Debug.cpp \
@@ -86,6 +86,7 @@
 #include <time.h>
 #include <stdarg.h>
 #include <new>
+#include <mutex>
 
 #ifndef	WIN32
 #include <unistd.h>
@@ -244,9 +245,10 @@ static		sAllocUnit	*reservoir;
 static		unsigned int	currentAllocationCount = 0;
 static		unsigned int	breakOnAllocationCount = 0;
 static		sMStats		stats;
-static	const	char		*sourceFile            = "??";
-static	const	char		*sourceFunc            = "??";
-static		unsigned int	sourceLine             = 0;
+// The owner set by m_setOwner() is only used by the next new/delete of the same thread
+static	thread_local	const	char	*sourceFile = "??";
+static	thread_local	const	char	*sourceFunc = "??";
+static	thread_local	unsigned int	sourceLine = 0;
 static		bool		staticDeinitTime       = false;
 static		sAllocUnit	**reservoirBuffer      = NULL;
 static		unsigned int	reservoirBufferSize    = 0;
@@ -254,6 +256,20 @@ static const	char		*memoryLogFile         = "memory.log";
 static const	char		*memoryLeakLogFile     = "memleaks.log";
 static		void		doCleanupLogOnFirstRun();
 
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The allocation table, the statistics and the static buffers of the reporting functions are shared by all the threads: every
+// entry point holds this lock. It is recursive as the entry points call each other, and never destroyed as memory is still released
+// during the static deinitialization
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	std::recursive_mutex	&managerMutex()
+{
+	static	std::recursive_mutex	*mutex = ::new(malloc(sizeof(std::recursive_mutex))) std::recursive_mutex;
+	return *mutex;
+}
+
+#define	MMGR_LOCK	std::lock_guard<std::recursive_mutex> mmgrLock(managerMutex())
+
 // ---------------------------------------------------------------------------------------------------------------------------------
 // Local functions only
 // ---------------------------------------------------------------------------------------------------------------------------------
@@ -642,6 +658,8 @@ bool	&m_randomeWipe()
 
 bool	&m_breakOnRealloc(void *reportedAddress)
 {
+	MMGR_LOCK;
+
 	// Locate the existing allocation unit
 
 	sAllocUnit	*au = findAllocUnit(reportedAddress);
@@ -666,6 +684,8 @@ bool	&m_breakOnRealloc(void *reportedAddress)
 
 bool	&m_breakOnDealloc(void *reportedAddress)
 {
+	MMGR_LOCK;
+
 	// Locate the existing allocation unit
 
 	sAllocUnit	*au = findAllocUnit(reportedAddress);
@@ -683,6 +703,8 @@ bool	&m_breakOnDealloc(void *reportedAddress)
 
 void	m_breakOnAllocation(unsigned int count)
 {
+	MMGR_LOCK;
+
 	breakOnAllocationCount = count;
 }
 
@@ -692,6 +714,8 @@ void	m_breakOnAllocation(unsigned int count)
 
 void	m_setOwner(const char *file, const unsigned int line, const char *func)
 {
+	MMGR_LOCK;
+
 	// You're probably wondering about this...
 	//
 	// It's important for this memory manager to primarily work with global new/delete in their original forms (i.e. with
@@ -995,6 +1019,8 @@ void	*operator new[](size_t reportedSize, const char *sourceFile, int sourceLine
 
 void	operator delete(void *reportedAddress)
 {
+	MMGR_LOCK;
+
 	#ifdef TEST_MEMORY_MANAGER
 	log("[D] ENTER: delete");
 	#endif
@@ -1018,6 +1044,8 @@ void	operator delete(void *reportedAddress)
 
 void	operator delete[](void *reportedAddress)
 {
+	MMGR_LOCK;
+
 	#ifdef TEST_MEMORY_MANAGER
 	log("[D] ENTER: delete[]");
 	#endif
@@ -1044,6 +1072,8 @@ void	operator delete[](void *reportedAddress)
 
 void	*m_allocator(const char *sourceFile, const unsigned int sourceLine, const char *sourceFunc, const unsigned int allocationType, const size_t reportedSize)
 {
+	MMGR_LOCK;
+
 	try
 	{
 		#ifdef TEST_MEMORY_MANAGER
@@ -1223,6 +1253,8 @@ void	*m_allocator(const char *sourceFile, const unsigned int sourceLine, const c
 
 void	*m_reallocator(const char *sourceFile, const unsigned int sourceLine, const char *sourceFunc, const unsigned int reallocationType, const size_t reportedSize, void *reportedAddress)
 {
+	MMGR_LOCK;
+
 	try
 	{
 		#ifdef TEST_MEMORY_MANAGER
@@ -1422,6 +1454,8 @@ void	*m_reallocator(const char *sourceFile, const unsigned int sourceLine, const
 
 void	m_deallocator(const char *sourceFile, const unsigned int sourceLine, const char *sourceFunc, const unsigned int deallocationType, const void *reportedAddress)
 {
+	MMGR_LOCK;
+
 	try
 	{
 		#ifdef TEST_MEMORY_MANAGER
@@ -1535,6 +1569,8 @@ void	m_deallocator(const char *sourceFile, const unsigned int sourceLine, const
 
 bool	m_validateAddress(const void *reportedAddress)
 {
+	MMGR_LOCK;
+
 	// Just see if the address exists in our allocation routines
 
 	return findAllocUnit(reportedAddress) != NULL;
@@ -1544,6 +1580,8 @@ bool	m_validateAddress(const void *reportedAddress)
 
 bool	m_validateAllocUnit(const sAllocUnit *allocUnit)
 {
+	MMGR_LOCK;
+
 	// Make sure the padding is untouched
 
 	long	*pre = reinterpret_cast<long *>(allocUnit->actualAddress);
@@ -1585,6 +1623,8 @@ bool	m_validateAllocUnit(const sAllocUnit *allocUnit)
 
 bool	m_validateAllAllocUnits()
 {
+	MMGR_LOCK;
+
 	// Just go through each allocation unit in the hash table and count the ones that have errors
 
 	unsigned int	errors = 0;
@@ -1634,6 +1674,8 @@ bool	m_validateAllAllocUnits()
 
 unsigned int	m_calcUnused(const sAllocUnit *allocUnit)
 {
+	MMGR_LOCK;
+
 	const unsigned long	*ptr = reinterpret_cast<const unsigned long *>(allocUnit->reportedAddress);
 	unsigned int		count = 0;
 
@@ -1649,6 +1691,8 @@ unsigned int	m_calcUnused(const sAllocUnit *allocUnit)
 
 unsigned int	m_calcAllUnused()
 {
+	MMGR_LOCK;
+
 	// Just go through each allocation unit in the hash table and count the unused RAM
 
 	unsigned int	total = 0;
@@ -1671,6 +1715,8 @@ unsigned int	m_calcAllUnused()
 
 void	m_dumpAllocUnit(const sAllocUnit *allocUnit, const char *prefix)
 {
+	MMGR_LOCK;
+
 	log("[I] %sAddress (reported): %010p",       prefix, allocUnit->reportedAddress);
 	log("[I] %sAddress (actual)  : %010p",       prefix, allocUnit->actualAddress);
 	log("[I] %sSize (reported)   : 0x%08X (%s)", prefix, static_cast<unsigned int>(allocUnit->reportedSize), memorySizeString(static_cast<unsigned int>(allocUnit->reportedSize)));
@@ -1684,6 +1730,8 @@ void	m_dumpAllocUnit(const sAllocUnit *allocUnit, const char *prefix)
 
 void	m_dumpMemoryReport(const char *filename, const bool overwrite)
 {
+	MMGR_LOCK;
+
 	// Open the report file
 
 	FILE	*fp = NULL;
@@ -1751,6 +1799,8 @@ void	m_dumpMemoryReport(const char *filename, const bool overwrite)
 
 sMStats	m_getMemoryStatistics()
 {
+	MMGR_LOCK;
+
 	return stats;
 }
 
@@ -0,0 +1,144 @@
+/*
+ BackendRegistry.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QPluginLoader>
+
+#include "BackendRegistry.h"
+#include "InstrumentInterfacePlugin.h"
+#include "Debug.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+BackendRegistry::BackendRegistry()
+{
+}
+
+BackendRegistry::~BackendRegistry()
+{
+  for (size_t i = 0; i < loaders_.size(); ++i) {
+    loaders_[i]->unload();
+    delete loaders_[i];
+  }
+}
+
+void BackendRegistry::add(InstrumentInterfacePlugin *plugin)
+{
+  for (size_t i = 0; i < plugins_.size(); ++i) {
+    if (plugins_[i]->name() == plugin->name()) {
+      plugins_[i] = plugin;
+      return;
+    }
+  }
+
+  plugins_.push_back(plugin);
+}
+
+int BackendRegistry::loadPlugins(const QString &dir)
+{
+  if (!dir.isEmpty())
+    return loadPluginsIn(dir);
+
+  QString path = QString::fromLocal8Bit(qgetenv("MZQT_PLUGIN_PATH"));
+  if (path.isEmpty())
+    return loadPluginsIn(QCoreApplication::applicationDirPath()
+        + "/mzqtplugins");
+
+  int numPlugins = 0;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+  QStringList dirs = path.split(QDir::listSeparator(), Qt::SkipEmptyParts);
+#else
+  QStringList dirs = path.split(QDir::listSeparator(),
+                                QString::SkipEmptyParts);
+#endif
+  foreach(const QString &d, dirs)
+    numPlugins += loadPluginsIn(d);
+
+  return numPlugins;
+}
+
+int BackendRegistry::loadPluginsIn(const QString &dir)
+{
+  QDir pluginDir(dir);
+  int numPlugins = 0;
+
+  foreach(const QString &fileName, pluginDir.entryList(QDir::Files))
+    {
+      QPluginLoader *loader = new QPluginLoader(pluginDir.absoluteFilePath(
+          fileName));
+      InstrumentInterfacePlugin *plugin = qobject_cast<
+          InstrumentInterfacePlugin *> (loader->instance());
+      if (plugin == NULL) {
+        errors_ << fileName + ": " + loader->errorString();
+        delete loader;
+        continue;
+      }
+
+      Debug::dbg(Debug::MEDIUM) << "backend " << plugin->name()
+          << " loaded from " << fileName << Debug::ENDL;
+      add(plugin);
+      loaders_.push_back(loader);
+      numPlugins++;
+    }
+
+  return numPlugins;
+}
+
+QStringList BackendRegistry::names() const
+{
+  QStringList names;
+  for (size_t i = 0; i < plugins_.size(); ++i)
+    names << plugins_[i]->name();
+
+  return names;
+}
+
+InstrumentInterfacePlugin *BackendRegistry::plugin(const QString &name) const
+{
+  for (size_t i = 0; i < plugins_.size(); ++i) {
+    if (plugins_[i]->name() == name)
+      return plugins_[i];
+  }
+
+  return NULL;
+}
+
+InstrumentInterface *BackendRegistry::create(const QString &name) const
+{
+  InstrumentInterfacePlugin *p = plugin(name);
+
+  return p != NULL ? p->create() : NULL;
+}
+
+InstrumentInterface *BackendRegistry::createFor(const QString &fileName) const
+{
+  for (size_t i = 0; i < plugins_.size(); ++i) {
+    if (plugins_[i]->canRead(fileName))
+      return plugins_[i]->create();
+  }
+
+  return NULL;
+}
@@ -0,0 +1,107 @@
+/*
+ BackendRegistry.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_BACKENDREGISTRY_H_
+#define MZQT_BACKENDREGISTRY_H_
+
+#include <vector>
+
+#include <QString>
+#include <QStringList>
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+class QPluginLoader;
+
+namespace mzqt {
+
+  class InstrumentInterface;
+  class InstrumentInterfacePlugin;
+
+  /*! Backends available to create an InstrumentInterface: the ones added
+   * by the application and the vendor plugins found at runtime. Typical
+   * use:
+   *
+   *   BackendRegistry registry;
+   *   registry.loadPlugins();
+   *   std::unique_ptr<InstrumentInterface> iface(registry.createFor(file));
+   *   if (!iface)
+   *     throw Exception("no backend for " + file.toStdString());
+   *   iface->initInterface();
+   *   iface->setInputFile(file);
+   */
+  class BackendRegistry {
+
+  public:
+    MZQTDLL_API BackendRegistry();
+    //! \brief the plugins are unloaded: the interfaces they created must
+    //! have been deleted
+    MZQTDLL_API ~BackendRegistry();
+
+    //! \brief add a backend built in the application, not owned. A backend
+    //! with the same name is replaced
+    MZQTDLL_API void add(InstrumentInterfacePlugin *plugin);
+
+    //! \brief load the plugins of dir, returns the number of backends
+    //! added. By default, the directories of MZQT_PLUGIN_PATH, or the
+    //! mzqtplugins directory next to the application. The files which are
+    //! not mzqt plugins are reported in errors_
+    MZQTDLL_API int loadPlugins(const QString &dir = QString());
+
+    MZQTDLL_API QStringList names() const;
+    //! \brief NULL if unknown
+    MZQTDLL_API InstrumentInterfacePlugin *plugin(const QString &name) const;
+
+    //! \brief new interface of backend name, NULL if unknown
+    MZQTDLL_API InstrumentInterface *create(const QString &name) const;
+    //! \brief new interface of the first backend which can read fileName,
+    //! NULL if none
+    MZQTDLL_API InstrumentInterface *createFor(const QString &fileName) const;
+
+    QStringList errors_;
+
+  private:
+    BackendRegistry(const BackendRegistry &); // intentionally undefined
+    BackendRegistry &operator=(const BackendRegistry &); // intentionally undefined
+
+    int loadPluginsIn(const QString &dir);
+
+    std::vector<InstrumentInterfacePlugin *> plugins_;
+    std::vector<QPluginLoader *> loaders_;
+  };
+
+}
+
+#endif /* MZQT_BACKENDREGISTRY_H_ */
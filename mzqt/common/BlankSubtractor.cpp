@@ -0,0 +1,253 @@
+/*
+ BlankSubtractor.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <algorithm>
+#include <cmath>
+
+#include "BlankSubtractor.h"
+#include "InstrumentInterface.h"
+#include "Scan.h"
+#include "Debug.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+BlankSubtractor::BlankSubtractor() :
+  subtractedPeaks_(0), removedPeaks_(0), retentionTimeTolerance_(30.0),
+      retentionTimeBinWidth_(10.0), scale_(1.0), msLevel_(1),
+      removeEmptyPeaks_(true)
+{
+  setTolerance(10.0);
+}
+
+void BlankSubtractor::setTolerance(double ppm)
+{
+  tolerance_ = ppm;
+  logBinWidth_ = std::log1p(ppm * 1.0e-6);
+}
+
+void BlankSubtractor::setRetentionTimeTolerance(double seconds)
+{
+  retentionTimeTolerance_ = seconds;
+}
+
+void BlankSubtractor::setRetentionTimeBinWidth(double seconds)
+{
+  retentionTimeBinWidth_ = seconds;
+}
+
+void BlankSubtractor::setScale(double scale)
+{
+  scale_ = scale;
+}
+
+void BlankSubtractor::setMSLevel(int msLevel)
+{
+  msLevel_ = msLevel;
+}
+
+void BlankSubtractor::setRemoveEmptyPeaks(bool remove)
+{
+  removeEmptyPeaks_ = remove;
+}
+
+long BlankSubtractor::mzBin(double mz) const
+{
+  return (long) std::floor(std::log(mz) / logBinWidth_);
+}
+
+int BlankSubtractor::rtBin(double seconds) const
+{
+  return (int) std::floor(seconds / retentionTimeBinWidth_);
+}
+
+void BlankSubtractor::loadBlank(InstrumentInterface &blank)
+{
+  Scan *scan;
+  while ((scan = blank.getScan()) != NULL) {
+    addBlankScan(*scan);
+    delete scan;
+  }
+
+  build();
+}
+
+bool BlankSubtractor::addBlankScan(const Scan &scan)
+{
+  if (scan.msLevel_ != msLevel_)
+    return false;
+
+  int rt = rtBin(scan.retentionTimeInSec_);
+  for (int i = 0; i < scan.getNumDataPoints(); ++i) {
+    if (scan.mzArray_[i] <= 0 || scan.intensityArray_[i] <= 0)
+      continue;
+    Bin bin = { mzBin(scan.mzArray_[i]), rt, (float) scan.intensityArray_[i] };
+    loading_.push_back(bin);
+  }
+
+  return true;
+}
+
+void BlankSubtractor::build()
+{
+  // bins added by previous builds are loaded again
+  for (size_t i = 0; i + 1 < offsets_.size(); ++i) {
+    for (size_t j = offsets_[i]; j < offsets_[i + 1]; ++j) {
+      Bin bin = { mzBins_[i], rtBins_[j], intensities_[j] };
+      loading_.push_back(bin);
+    }
+  }
+
+  std::sort(loading_.begin(), loading_.end(), [](const Bin &a, const Bin &b) {
+    return a.mz != b.mz ? a.mz < b.mz : a.rt < b.rt;
+  });
+
+  mzBins_.clear();
+  offsets_.clear();
+  rtBins_.clear();
+  intensities_.clear();
+
+  for (size_t i = 0; i < loading_.size(); ++i) {
+    const Bin &bin = loading_[i];
+    if (mzBins_.empty() || mzBins_.back() != bin.mz) {
+      mzBins_.push_back(bin.mz);
+      offsets_.push_back(rtBins_.size());
+    }
+    else if (rtBins_.back() == bin.rt) {
+      intensities_.back() = std::max(intensities_.back(), bin.intensity);
+      continue;
+    }
+    rtBins_.push_back(bin.rt);
+    intensities_.push_back(bin.intensity);
+  }
+  offsets_.push_back(rtBins_.size());
+
+  std::vector<Bin>().swap(loading_);
+
+  Debug::dbg(Debug::MEDIUM) << "blank model: " << mzBins_.size()
+      << " m/z bins, " << rtBins_.size() << " bins" << Debug::ENDL;
+}
+
+void BlankSubtractor::clear()
+{
+  loading_.clear();
+  mzBins_.clear();
+  offsets_.clear();
+  rtBins_.clear();
+  intensities_.clear();
+}
+
+size_t BlankSubtractor::size() const
+{
+  return rtBins_.size();
+}
+
+double BlankSubtractor::blankIntensity(size_t mzIndex, int rt) const
+{
+  int rtTolerance = (int) std::ceil(retentionTimeTolerance_
+      / retentionTimeBinWidth_);
+
+  std::vector<int>::const_iterator begin = rtBins_.begin() + offsets_[mzIndex];
+  std::vector<int>::const_iterator end = rtBins_.begin()
+      + offsets_[mzIndex + 1];
+
+  double intensity = 0;
+  for (std::vector<int>::const_iterator it = std::lower_bound(begin, end, rt
+      - rtTolerance); it != end && *it <= rt + rtTolerance; ++it)
+    intensity = std::max<double>(intensity, intensities_[it
+        - rtBins_.begin()]);
+
+  return intensity;
+}
+
+bool BlankSubtractor::subtract(Scan &scan)
+{
+  if (scan.msLevel_ != msLevel_ || mzBins_.empty())
+    return false;
+
+  int rt = rtBin(scan.retentionTimeInSec_);
+  int numPeaks = scan.getNumDataPoints();
+  size_t cursor = 0;
+  int kept = 0;
+  bool changed = false;
+
+  for (int i = 0; i < numPeaks; ++i) {
+    double mz = scan.mzArray_[i];
+    double intensity = scan.intensityArray_[i];
+    bool subtracted = false;
+
+    if (mz > 0) {
+      long bin = mzBin(mz);
+
+      // peaks are sorted: the cursor only moves forward, unless the scan
+      // is not sorted
+      if (cursor > 0 && mzBins_[cursor - 1] >= bin - 1)
+        cursor = 0;
+      cursor = std::lower_bound(mzBins_.begin() + cursor, mzBins_.end(), bin
+          - 1) - mzBins_.begin();
+
+      double blank = 0;
+      for (size_t j = cursor; j < mzBins_.size() && mzBins_[j] <= bin + 1; ++j)
+        blank = std::max(blank, blankIntensity(j, rt));
+
+      if (blank > 0) {
+        intensity = std::max(0.0, intensity - scale_ * blank);
+        subtractedPeaks_++;
+        subtracted = true;
+        changed = true;
+      }
+    }
+
+    if (removeEmptyPeaks_ && subtracted && intensity <= 0) {
+      removedPeaks_++;
+      changed = true;
+      continue;
+    }
+    scan.mzArray_[kept] = mz;
+    scan.intensityArray_[kept] = intensity;
+    ++kept;
+  }
+
+  if (!changed)
+    return false;
+
+  scan.resetNumDataPoints(kept);
+
+  scan.totalIonCurrent_ = 0;
+  scan.basePeakMZ_ = -1;
+  scan.basePeakIntensity_ = 0;
+  for (int i = 0; i < kept; ++i) {
+    scan.totalIonCurrent_ += scan.intensityArray_[i];
+    if (scan.intensityArray_[i] > scan.basePeakIntensity_) {
+      scan.basePeakMZ_ = scan.mzArray_[i];
+      scan.basePeakIntensity_ = scan.intensityArray_[i];
+    }
+  }
+  if (kept > 0) {
+    scan.minObservedMZ_ = scan.mzArray_[0];
+    scan.maxObservedMZ_ = scan.mzArray_[kept - 1];
+  }
+
+  return true;
+}
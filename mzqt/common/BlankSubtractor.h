@@ -0,0 +1,132 @@
+/*
+ BlankSubtractor.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_BLANKSUBTRACTOR_H_
+#define MZQT_BLANKSUBTRACTOR_H_
+
+#include <vector>
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+namespace mzqt {
+
+  class Scan;
+  class InstrumentInterface;
+
+  /*! Subtract the background of a blank run from the scans of a sample.
+   *
+   * The blank is loaded once into a m/z x retention time binned model: m/z
+   * bins are tolerance ppm wide (logarithmic), retention time bins are
+   * fixed width. The model keeps the highest blank intensity of each bin,
+   * sorted by m/z bin then retention time bin.
+   *
+   * subtract() walks the peaks of a scan and the sorted m/z bins together
+   * and removes the blank intensity found within one m/z bin and within the
+   * retention time tolerance. It works in place and does not allocate.
+   *
+   *   subtractor.loadBlank(blankInterface);
+   *   while ((scan = iface.getScan()) != NULL) {
+   *     subtractor.subtract(*scan);
+   *     ...
+   *   }
+   */
+  class BlankSubtractor {
+
+  public:
+    MZQTDLL_API BlankSubtractor();
+
+    MZQTDLL_API void setTolerance(double ppm);
+    MZQTDLL_API void setRetentionTimeTolerance(double seconds);
+    MZQTDLL_API void setRetentionTimeBinWidth(double seconds);
+    //! \brief multiplier applied to the blank intensity
+    MZQTDLL_API void setScale(double scale);
+    //! \brief ms level of the scans modelled and subtracted, default 1
+    MZQTDLL_API void setMSLevel(int msLevel);
+    //! \brief remove the peaks left with no intensity by the subtraction,
+    //! default true. The zero points of a profile scan are kept
+    MZQTDLL_API void setRemoveEmptyPeaks(bool remove);
+
+    //! \brief read every scan of blank and build the model
+    MZQTDLL_API void loadBlank(InstrumentInterface &blank);
+
+    //! \brief add a scan of the blank run, build() must be called once all
+    //! the scans have been added
+    MZQTDLL_API bool addBlankScan(const Scan &scan);
+    MZQTDLL_API void build();
+    MZQTDLL_API void clear();
+
+    //! \brief number of (m/z, retention time) bins of the model
+    MZQTDLL_API size_t size() const;
+
+    //! \brief subtract the blank from scan, returns true if the scan has
+    //! been changed
+    MZQTDLL_API bool subtract(Scan &scan);
+
+    long subtractedPeaks_; //!< peaks with blank intensity removed
+    long removedPeaks_; //!< peaks removed from the scans
+
+  private:
+
+    struct Bin {
+      long mz;
+      int rt;
+      float intensity;
+    };
+
+    long mzBin(double mz) const;
+    int rtBin(double seconds) const;
+    double blankIntensity(size_t mzIndex, int rt) const;
+
+    double tolerance_; //!< ppm
+    double logBinWidth_;
+    double retentionTimeTolerance_; //!< seconds
+    double retentionTimeBinWidth_; //!< seconds
+    double scale_;
+    int msLevel_;
+    bool removeEmptyPeaks_;
+
+    std::vector<Bin> loading_; //!< bins added before build()
+
+    // model, compressed by m/z bin: the retention time bins of mzBins_[i]
+    // are rtBins_[offsets_[i]] to rtBins_[offsets_[i + 1] - 1]
+    std::vector<long> mzBins_;
+    std::vector<size_t> offsets_;
+    std::vector<int> rtBins_;
+    std::vector<float> intensities_;
+  };
+
+}
+
+#endif /* MZQT_BLANKSUBTRACTOR_H_ */
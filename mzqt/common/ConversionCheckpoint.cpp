@@ -0,0 +1,250 @@
+/*
+ ConversionCheckpoint.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <cstring>
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStringList>
+#include <QTextStream>
+
+#include "ConversionCheckpoint.h"
+#include "InstrumentInterface.h"
+#include "Exception.h"
+#include "Scan.h"
+#include "Debug.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+namespace {
+
+  const char *HEADER = "# mzqt conversion checkpoint";
+  const char *INPUT_KEY = "input";
+  const char *MODIFIED_KEY = "inputModified";
+  const char *LAST_SCAN_KEY = "lastScan";
+  const char *OFFSET_PREFIX = "offset.";
+  const char *VALUE_PREFIX = "value.";
+
+}
+
+ConversionCheckpoint::ConversionCheckpoint(const QString &path) :
+  savedCheckpoints_(0), path_(path), intervalScans_(1000),
+      intervalMs_(60000), iface_(NULL), lastScanNumber_(-1),
+      scansSinceSave_(0), lastSaveTime_(Clock::now())
+{
+}
+
+void ConversionCheckpoint::setPath(const QString &path)
+{
+  path_ = path;
+}
+
+QString ConversionCheckpoint::path() const
+{
+  return path_;
+}
+
+void ConversionCheckpoint::setInterval(long numScans, long ms)
+{
+  intervalScans_ = numScans;
+  intervalMs_ = ms;
+}
+
+void ConversionCheckpoint::setInterface(InstrumentInterface *iface)
+{
+  iface_ = iface;
+}
+
+void ConversionCheckpoint::setInputFile(const QString &fileName)
+{
+  QFileInfo info(fileName);
+  inputFile_ = info.absoluteFilePath();
+  inputModified_ = info.lastModified().toString(Qt::ISODate);
+}
+
+bool ConversionCheckpoint::isDue() const
+{
+  return (intervalScans_ > 0 && scansSinceSave_ + 1 >= intervalScans_)
+      || (intervalMs_ > 0 && Clock::now() - lastSaveTime_
+          >= std::chrono::milliseconds(intervalMs_));
+}
+
+bool ConversionCheckpoint::completed(long scanNumber)
+{
+  bool due = isDue();
+
+  lastScanNumber_ = scanNumber;
+  scansSinceSave_++;
+  if (due)
+    save();
+
+  return due;
+}
+
+long ConversionCheckpoint::lastScanNumber() const
+{
+  return lastScanNumber_;
+}
+
+void ConversionCheckpoint::setWriterOffset(const QString &writer,
+                                           qint64 offset)
+{
+  writerOffsets_[writer] = offset;
+}
+
+qint64 ConversionCheckpoint::writerOffset(const QString &writer) const
+{
+  return writerOffsets_.value(writer, -1);
+}
+
+void ConversionCheckpoint::setValue(const QString &key, const QString &value)
+{
+  values_[key] = value;
+}
+
+QString ConversionCheckpoint::value(const QString &key,
+                                    const QString &defaultValue) const
+{
+  return values_.value(key, defaultValue);
+}
+
+void ConversionCheckpoint::save()
+{
+  if (iface_ != NULL)
+    iface_->saveState(*this);
+
+  // written aside then renamed: the previous checkpoint stays valid until
+  // the new one is complete
+  QSaveFile file(path_);
+  if (file.open(QIODevice::WriteOnly | QIODevice::Text) == false)
+    throw Exception(QString("unable to write checkpoint %1: %2").arg(path_).arg(
+        file.errorString()).toStdString());
+
+  QTextStream stream(&file);
+  stream << HEADER << "\n";
+  stream << INPUT_KEY << "=" << inputFile_ << "\n";
+  stream << MODIFIED_KEY << "=" << inputModified_ << "\n";
+  stream << LAST_SCAN_KEY << "=" << lastScanNumber_ << "\n";
+  for (QMap<QString, qint64>::const_iterator it =
+      writerOffsets_.constBegin(); it != writerOffsets_.constEnd(); ++it)
+    stream << OFFSET_PREFIX << it.key() << "=" << it.value() << "\n";
+  for (QMap<QString, QString>::const_iterator it = values_.constBegin(); it
+      != values_.constEnd(); ++it)
+    stream << VALUE_PREFIX << it.key() << "=" << it.value() << "\n";
+  stream.flush();
+
+  if (file.commit() == false)
+    throw Exception(QString("unable to write checkpoint %1: %2").arg(path_).arg(
+        file.errorString()).toStdString());
+
+  scansSinceSave_ = 0;
+  lastSaveTime_ = Clock::now();
+  savedCheckpoints_++;
+
+  Debug::dbg(Debug::HIGH) << "checkpoint saved at scan " << lastScanNumber_
+      << Debug::ENDL;
+}
+
+bool ConversionCheckpoint::load()
+{
+  QFile file(path_);
+  if (file.open(QIODevice::ReadOnly | QIODevice::Text) == false)
+    return false;
+
+  QString input, modified;
+  long lastScanNumber = -1;
+  QMap<QString, qint64> writerOffsets;
+  QMap<QString, QString> values;
+
+  QTextStream stream(&file);
+  while (!stream.atEnd()) {
+    QString line = stream.readLine();
+    int separator = line.indexOf('=');
+    if (line.startsWith('#') || separator < 0)
+      continue;
+
+    QString key = line.left(separator);
+    QString value = line.mid(separator + 1);
+    if (key == INPUT_KEY)
+      input = value;
+    else if (key == MODIFIED_KEY)
+      modified = value;
+    else if (key == LAST_SCAN_KEY)
+      lastScanNumber = value.toLong();
+    else if (key.startsWith(OFFSET_PREFIX))
+      writerOffsets[key.mid(strlen(OFFSET_PREFIX))] = value.toLongLong();
+    else if (key.startsWith(VALUE_PREFIX))
+      values[key.mid(strlen(VALUE_PREFIX))] = value;
+  }
+
+  if (!inputFile_.isEmpty() && (input != inputFile_ || modified
+      != inputModified_)) {
+    Debug::dbg(Debug::LOW) << "checkpoint " << path_ << " is for "
+        << input << ", ignored" << Debug::ENDL;
+    return false;
+  }
+
+  lastScanNumber_ = lastScanNumber;
+  writerOffsets_ = writerOffsets;
+  values_ = values;
+  scansSinceSave_ = 0;
+  lastSaveTime_ = Clock::now();
+
+  return true;
+}
+
+void ConversionCheckpoint::remove()
+{
+  QFile::remove(path_);
+}
+
+bool ConversionCheckpoint::resume()
+{
+  if (!load() || lastScanNumber_ < 0)
+    return false;
+
+  if (iface_ == NULL)
+    return true;
+
+  iface_->restoreState(*this);
+
+  if (!iface_->seek(lastScanNumber_ + 1)) {
+    // every scan was written: only the end of the conversion is missing
+    if (lastScanNumber_ < iface_->lastScanNumber_ || !iface_->seek(
+        lastScanNumber_))
+      return false;
+    bool headerOnly = iface_->headerOnly_;
+    iface_->setHeaderOnly(true);
+    delete iface_->getScan();
+    iface_->setHeaderOnly(headerOnly);
+  }
+
+  Debug::dbg(Debug::LOW) << "resuming after scan " << lastScanNumber_
+      << Debug::ENDL;
+
+  return true;
+}
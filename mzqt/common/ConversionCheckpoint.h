@@ -0,0 +1,141 @@
+/*
+ ConversionCheckpoint.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_CONVERSIONCHECKPOINT_H_
+#define MZQT_CONVERSIONCHECKPOINT_H_
+
+#include <chrono>
+
+#include <QMap>
+#include <QString>
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+namespace mzqt {
+
+  class InstrumentInterface;
+
+  /*! Periodic checkpoint of a long conversion, to resume it after a crash
+   * instead of starting over.
+   *
+   * A checkpoint holds the last scan completely written, the offsets of
+   * the writers and the state of the interface (see
+   * InstrumentInterface::saveState()). It is written to a temporary file
+   * renamed over the previous one, so that a crash while saving leaves the
+   * previous checkpoint intact. Typical use:
+   *
+   *   ConversionCheckpoint checkpoint(outputFile + ".checkpoint");
+   *   checkpoint.setInterface(&iface);
+   *   checkpoint.setInputFile(inputFile);
+   *   if (checkpoint.resume())
+   *     writer.truncate(checkpoint.writerOffset("mzXML"));
+   *   while ((scan = iface.getScan()) != NULL) {
+   *     writer.write(*scan);
+   *     checkpoint.setWriterOffset("mzXML", writer.pos());
+   *     checkpoint.completed(scan->scanNumber_);
+   *     delete scan;
+   *   }
+   *   checkpoint.remove();
+   *
+   * The interface must not have read beyond the completed scan when a
+   * checkpoint is saved: ScanPipeline drains its scans before saving.
+   */
+  class ConversionCheckpoint {
+
+  public:
+    MZQTDLL_API explicit ConversionCheckpoint(const QString &path = QString());
+
+    MZQTDLL_API void setPath(const QString &path);
+    MZQTDLL_API QString path() const;
+    //! \brief save every numScans completed scans or every ms milliseconds,
+    //! 0 disables the corresponding criterion
+    MZQTDLL_API void setInterval(long numScans, long ms);
+    //! \brief interface whose state is saved and restored, not owned
+    MZQTDLL_API void setInterface(InstrumentInterface *iface);
+    //! \brief the checkpoint of another file, or of a modified one, is not
+    //! resumed
+    MZQTDLL_API void setInputFile(const QString &fileName);
+
+    //! \brief scanNumber has been completely written: save a checkpoint if
+    //! due. Returns true if saved
+    MZQTDLL_API bool completed(long scanNumber);
+    //! \brief true if the next completed() saves a checkpoint
+    MZQTDLL_API bool isDue() const;
+    //! \brief last completed scan, -1 if none
+    MZQTDLL_API long lastScanNumber() const;
+
+    MZQTDLL_API void setWriterOffset(const QString &writer, qint64 offset);
+    //! \brief -1 if unknown
+    MZQTDLL_API qint64 writerOffset(const QString &writer) const;
+
+    //! \brief state of the conversion steps, on a single line
+    MZQTDLL_API void setValue(const QString &key, const QString &value);
+    MZQTDLL_API QString value(const QString &key,
+        const QString &defaultValue = QString()) const;
+
+    //! \brief write the checkpoint now, throws Exception if it can't
+    MZQTDLL_API void save();
+    //! \brief read the checkpoint, false if there is none for the input file
+    MZQTDLL_API bool load();
+    //! \brief once the conversion is over
+    MZQTDLL_API void remove();
+
+    //! \brief load() then restore the state of the interface and make the
+    //! scan following the last completed one the next scan of getScan().
+    //! False if there is nothing to resume
+    MZQTDLL_API bool resume();
+
+    long savedCheckpoints_;
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    QString path_;
+    long intervalScans_;
+    long intervalMs_;
+    InstrumentInterface *iface_;
+    QString inputFile_;
+    QString inputModified_;
+
+    long lastScanNumber_;
+    long scansSinceSave_;
+    Clock::time_point lastSaveTime_;
+    QMap<QString, qint64> writerOffsets_;
+    QMap<QString, QString> values_;
+  };
+
+}
+
+#endif /* MZQT_CONVERSIONCHECKPOINT_H_ */
@@ -0,0 +1,241 @@
+/*
+ Dataset.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "Dataset.h"
+#include "BackendRegistry.h"
+#include "InstrumentInterface.h"
+#include "Exception.h"
+#include "Scan.h"
+#include "Debug.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+Dataset::Dataset(size_t depth) :
+  waits_(0), order_(DATASET_FIRST_READY), depth_(depth), activeRuns_(0),
+      nextRun_(0)
+{
+}
+
+Dataset::~Dataset()
+{
+  stop();
+
+  for (size_t i = 0; i < runs_.size(); ++i) {
+    if (runs_[i]->owned_)
+      delete runs_[i]->iface_;
+    delete runs_[i];
+  }
+}
+
+void Dataset::setOrder(DatasetOrder order)
+{
+  order_ = order;
+}
+
+void Dataset::setDepth(size_t depth)
+{
+  depth_ = depth;
+}
+
+size_t Dataset::depth() const
+{
+  return depth_;
+}
+
+void Dataset::setThreadHooks(const std::function<void()> &begin,
+                             const std::function<void()> &end)
+{
+  beginHook_ = begin;
+  endHook_ = end;
+}
+
+int Dataset::addRun(InstrumentInterface &iface, const QString &name)
+{
+  Run *run = new Run;
+  run->iface_ = &iface;
+  run->owned_ = false;
+  run->name_ = name;
+  run->head_ = NULL;
+  run->ended_ = true;
+  run->numScans_ = 0;
+  runs_.push_back(run);
+
+  return int(runs_.size()) - 1;
+}
+
+int Dataset::open(const QString &fileName, const BackendRegistry &registry)
+{
+  std::unique_ptr<InstrumentInterface> iface(registry.createFor(fileName));
+  if (!iface)
+    throw Exception(QString("no backend to read %1").arg(fileName).toStdString());
+
+  iface->initInterface();
+  if (iface->setInputFile(fileName) == false)
+    throw Exception(QString("unable to open %1").arg(fileName).toStdString());
+
+  int run = addRun(*iface, fileName);
+  runs_[run]->owned_ = true;
+  iface.release();
+
+  return run;
+}
+
+int Dataset::numRuns() const
+{
+  return int(runs_.size());
+}
+
+const QString &Dataset::runName(int run) const
+{
+  return runs_[run]->name_;
+}
+
+InstrumentInterface &Dataset::runInterface(int run) const
+{
+  return *runs_[run]->iface_;
+}
+
+long Dataset::numScans(int run) const
+{
+  return runs_[run]->numScans_;
+}
+
+void Dataset::start()
+{
+  stop();
+
+  Debug::dbg(Debug::MEDIUM) << "reading " << (int) runs_.size() << " runs"
+      << Debug::ENDL;
+
+  waits_ = 0;
+  nextRun_ = 0;
+  activeRuns_ = int(runs_.size());
+  for (size_t i = 0; i < runs_.size(); ++i) {
+    Run &run = *runs_[i];
+    run.reader_.reset(new PrefetchReader(*run.iface_, depth_));
+    run.reader_->setThreadHooks(beginHook_, endHook_);
+    run.reader_->start();
+    run.ended_ = false;
+    run.numScans_ = 0;
+  }
+}
+
+Scan *Dataset::getScan()
+{
+  if (order_ == DATASET_RETENTION_TIME)
+    return nextByTime();
+
+  return nextReady();
+}
+
+Scan *Dataset::take(int run, Scan *scan)
+{
+  scan->runIndex_ = run;
+  runs_[run]->numScans_++;
+
+  return scan;
+}
+
+Scan *Dataset::nextReady()
+{
+  for (int spins = 0; activeRuns_ > 0; ++spins) {
+    // round robin from the run after the last one served, so that a fast
+    // run does not starve the others
+    for (size_t k = 0; k < runs_.size(); ++k) {
+      size_t i = (nextRun_ + k) % runs_.size();
+      Run &run = *runs_[i];
+      if (run.ended_)
+        continue;
+
+      Scan *scan = NULL;
+      if (run.reader_->tryGetScan(scan) == false)
+        continue;
+
+      if (scan == NULL) {
+        run.ended_ = true;
+        activeRuns_--;
+        continue;
+      }
+
+      nextRun_ = i + 1;
+      return take(int(i), scan);
+    }
+
+    if (activeRuns_ == 0)
+      break;
+
+    if (spins == 0)
+      waits_++;
+    backoff(spins);
+  }
+
+  return NULL;
+}
+
+Scan *Dataset::nextByTime()
+{
+  // the readers go on in parallel while waiting for the slowest head
+  int first = -1;
+  for (size_t i = 0; i < runs_.size(); ++i) {
+    Run &run = *runs_[i];
+    if (run.ended_)
+      continue;
+
+    if (run.head_ == NULL) {
+      run.head_ = run.reader_->getScan();
+      if (run.head_ == NULL) {
+        run.ended_ = true;
+        activeRuns_--;
+        continue;
+      }
+    }
+
+    if (first < 0 || run.head_->retentionTimeInSec_
+        < runs_[first]->head_->retentionTimeInSec_)
+      first = int(i);
+  }
+
+  if (first < 0)
+    return NULL;
+
+  Scan *scan = runs_[first]->head_;
+  runs_[first]->head_ = NULL;
+
+  return take(first, scan);
+}
+
+void Dataset::stop()
+{
+  for (size_t i = 0; i < runs_.size(); ++i) {
+    Run &run = *runs_[i];
+    if (run.reader_)
+      run.reader_->stop();
+    delete run.head_;
+    run.head_ = NULL;
+    run.ended_ = true;
+  }
+
+  activeRuns_ = 0;
+}
@@ -0,0 +1,137 @@
+/*
+ Dataset.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_DATASET_H_
+#define MZQT_DATASET_H_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <QString>
+
+#include "PrefetchReader.h"
+
+namespace mzqt {
+
+  class Scan;
+  class InstrumentInterface;
+  class BackendRegistry;
+
+  enum DatasetOrder {
+    DATASET_FIRST_READY, //!< first scan read by any run, runs interleaved
+    DATASET_RETENTION_TIME //!< scans of all runs merged by retention time
+  };
+
+  /*! Several runs read through one getScan(), each scan tagged with the
+   * index of its run in Scan::runIndex_.
+   *
+   * Every run is read by its own PrefetchReader: the slow vendor calls of a
+   * run overlap with the ones of the other runs and with the caller work.
+   * Typical use:
+   *
+   *   Dataset dataset;
+   *   foreach (const QString &file, files)
+   *     dataset.open(file, registry);
+   *   dataset.start();
+   *   while ((scan = dataset.getScan()) != NULL) {
+   *     ... dataset.runName(scan->runIndex_) ...
+   *     delete scan;
+   *   }
+   *
+   * Each run holds up to depth() scans in memory and one reader thread.
+   */
+  class Dataset {
+
+  public:
+    MZQTDLL_API explicit Dataset(size_t depth = 16);
+    //! \brief the readers are stopped and the interfaces created by open()
+    //! deleted
+    MZQTDLL_API ~Dataset();
+
+    //! \brief taken into account by start()
+    MZQTDLL_API void setOrder(DatasetOrder order);
+    //! \brief scans read ahead per run, taken into account by start()
+    MZQTDLL_API void setDepth(size_t depth);
+    MZQTDLL_API size_t depth() const;
+    //! \brief see PrefetchReader::setThreadHooks(), called in every reader
+    //! thread
+    MZQTDLL_API void setThreadHooks(const std::function<void()> &begin,
+        const std::function<void()> &end);
+
+    //! \brief add a run read from the current position of iface, not owned.
+    //! Returns the index of the run
+    MZQTDLL_API int addRun(InstrumentInterface &iface, const QString &name);
+    //! \brief open fileName with the first backend of registry which can
+    //! read it. Returns the index of the run, throws Exception if fileName
+    //! cannot be opened
+    MZQTDLL_API int open(const QString &fileName,
+        const BackendRegistry &registry);
+
+    MZQTDLL_API int numRuns() const;
+    MZQTDLL_API const QString &runName(int run) const;
+    MZQTDLL_API InstrumentInterface &runInterface(int run) const;
+    //! \brief scans returned so far for run
+    MZQTDLL_API long numScans(int run) const;
+
+    //! \brief start reading all the runs
+    MZQTDLL_API void start();
+
+    //! \brief next scan, owned by the caller, NULL after the last scan of
+    //! the last run. An exception thrown while reading a run is thrown
+    //! again here
+    MZQTDLL_API Scan *getScan();
+
+    //! \brief stop all the readers and delete the scans not taken
+    MZQTDLL_API void stop();
+
+    long waits_; //!< no run had a scan ready: all readers were busy
+
+  private:
+    Dataset(const Dataset &); // intentionally undefined
+    Dataset &operator=(const Dataset &); // intentionally undefined
+
+    struct Run {
+      InstrumentInterface *iface_;
+      bool owned_;
+      QString name_;
+      std::unique_ptr<PrefetchReader> reader_;
+      Scan *head_; // next scan in retention time order
+      bool ended_;
+      long numScans_;
+    };
+
+    Scan *nextReady();
+    Scan *nextByTime();
+    Scan *take(int run, Scan *scan);
+
+    std::vector<Run *> runs_;
+    DatasetOrder order_;
+    size_t depth_;
+    std::function<void()> beginHook_;
+    std::function<void()> endHook_;
+    int activeRuns_;
+    size_t nextRun_;
+  };
+
+}
+
+#endif /* MZQT_DATASET_H_ */
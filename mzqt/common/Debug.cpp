@@ -19,10 +19,15 @@
  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <atomic>
+#include <mutex>
+
 #include <QFileInfo>
 #include <QString>
 #include <QStringList>
 #include <QProcess>
+#include <QMutex>
+#include <QMutexLocker>
 
 #include "Debug.h"
 
@@ -38,47 +43,73 @@ namespace mzqt {
     bool setFile(const QString &path);
     bool possible(Level requestLevel);
     bool init(Level level);
+    bool readEnvironment();
+
+    //! message being built by a thread: the interfaces may run in
+    //! different threads
+    struct Line {
+      Line() :
+        requestLevel_(Debug::LEVEL_UNDEFINED), buffer_(), stream_(&buffer_)
+      {
+      }
+
+      Debug::Level requestLevel_;
+      QString buffer_;
+      QTextStream stream_;
+    };
+    static Line &line();
 
-    Debug::Level level_;
-    Debug::Level requestLevel_;
-    QString buffer_;
-    QTextStream stream_;
+    std::atomic<int> level_;
+    std::once_flag initFlag_;
+    QMutex fileMutex_; // file_ is written by all the threads
     QFile file_;
   };
 }
 
 Debug::Manager::Manager() :
-  level_(Debug::LEVEL_UNDEFINED), requestLevel_(Debug::LEVEL_UNDEFINED),
-      buffer_(), stream_(&buffer_)
+  level_(Debug::LEVEL_UNDEFINED)
 {
 
 }
 
+Debug::Manager::Line &Debug::Manager::line()
+{
+  static thread_local Line line;
+
+  return line;
+}
+
 void Debug::Manager::flush(bool addEndLine)
 {
-  if (possible(requestLevel_)) {
+  Line &l = line();
+  if (possible(l.requestLevel_)) {
 #if 0
-    qt_message_output(QtDebugMsg, buffer_.toLocal8Bit().data());
+    qt_message_output(QtDebugMsg, l.buffer_.toLocal8Bit().data());
 #else
-    qDebug(buffer_.toLocal8Bit().data());
+    qDebug(l.buffer_.toLocal8Bit().data());
 #endif
 
+    QMutexLocker locker(&fileMutex_);
     if (file_.isOpen() == true) {
 
       if (addEndLine)
-        stream_ << endl;
+        l.stream_ << endl;
 
-      file_.write(buffer_.toLocal8Bit());
+      file_.write(l.buffer_.toLocal8Bit());
       file_.flush();
     }
+    locker.unlock();
 
-    buffer_.clear();
+    l.buffer_.clear();
   }
 }
 
 bool Debug::Manager::setFile(const QString &path)
 {
+  QMutexLocker locker(&fileMutex_);
   bool result = true;
+  if (file_.isOpen())
+    file_.close();
   file_.setFileName(path);
   if (file_.open(QIODevice::WriteOnly | QIODevice::Text) == false) {
     qDebug() << "unable to open debugging file: " << path;
@@ -90,7 +121,8 @@ bool Debug::Manager::setFile(const QString &path)
 
 bool Debug::Manager::possible(Level requestLevel)
 {
-  return requestLevel <= level_ && requestLevel != LEVEL_UNDEFINED || level_
+  int level = level_.load(std::memory_order_relaxed);
+  return requestLevel <= level && requestLevel != LEVEL_UNDEFINED || level
       == ALWAYS;
 }
 
@@ -98,62 +130,78 @@ bool Debug::Manager::init(Level level)
 {
   bool result = true;
 
-  if (level_ == LEVEL_UNDEFINED) {
-    //first time, setup using environment variables
-    level_ = NONE;
+  //first time, setup using environment variables
+  if (level_.load(std::memory_order_acquire) == LEVEL_UNDEFINED)
+    std::call_once(initFlag_, [this, &result]() {
+      result = readEnvironment();
+    });
 
-    QStringList env = QProcess::systemEnvironment();
-    QString componentName;
-    foreach(const QString &s, env)
-      {
-        QStringList var = s.split('=');
-        if (var.value(0) == "MZQT_DEBUG_LEVEL") {
-          bool ok = false;
-          int varLevel = var.value(1).toInt(&ok);
-          if (!ok || varLevel < Debug::ALWAYS || varLevel > Debug::VERY_HIGH) {
-            qDebug() << "invalid MZQT_DEBUG_LEVEL value:" << var.value(1);
-            result = false;
-          }
-          else {
-            level_ = (Debug::Level) varLevel;
-          }
+  Line &l = line();
+  if (l.requestLevel_ != level && level != LEVEL_UNDEFINED)
+    l.requestLevel_ = level; //set a new request level for printing
+
+  return result;
+}
+
+bool Debug::Manager::readEnvironment()
+{
+  bool result = true;
+
+  Debug::Level envLevel = NONE;
+
+  QStringList env = QProcess::systemEnvironment();
+  QString componentName;
+  foreach(const QString &s, env)
+    {
+      QStringList var = s.split('=');
+      if (var.value(0) == "MZQT_DEBUG_LEVEL") {
+        bool ok = false;
+        int varLevel = var.value(1).toInt(&ok);
+        if (!ok || varLevel < Debug::ALWAYS || varLevel > Debug::VERY_HIGH) {
+          qDebug() << "invalid MZQT_DEBUG_LEVEL value:" << var.value(1);
+          result = false;
         }
-        else if (var.value(0) == "MZQT_DEBUG_FILE") {
-          file_.setFileName(var.value(1));
-          if (file_.open(QIODevice::WriteOnly | QIODevice::Text) == false) {
-            qDebug() << "invalid MZQT_DEBUG_FILE value:" << var.value(1);
-            result = false;
-          }
+        else {
+          envLevel = (Debug::Level) varLevel;
         }
       }
-  }
+      else if (var.value(0) == "MZQT_DEBUG_FILE") {
+        QMutexLocker locker(&fileMutex_);
+        file_.setFileName(var.value(1));
+        if (file_.open(QIODevice::WriteOnly | QIODevice::Text) == false) {
+          qDebug() << "invalid MZQT_DEBUG_FILE value:" << var.value(1);
+          result = false;
+        }
+      }
+    }
 
-  if (requestLevel_ != level && level != LEVEL_UNDEFINED)
-    requestLevel_ = level; //set a new request level for printing
+  // a level set by setLevel() in the meantime is kept
+  int undefined = LEVEL_UNDEFINED;
+  level_.compare_exchange_strong(undefined, envLevel);
 
   return result;
 }
 ///////////////////////////////////////////////////////////////////////////////
 Debug::Level Debug::level()
 {
-  return manager().level_;
+  return (Level) manager().level_.load(std::memory_order_relaxed);
 }
 
 void Debug::setLevel(Level level)
 {
   //unedefined only for first time
   if (level != LEVEL_UNDEFINED)
-    manager().level_ = level;
+    manager().level_.store(level, std::memory_order_release);
 }
 
 Debug::Level Debug::requestLevel()
 {
-  return manager().requestLevel_;
+  return Manager::line().requestLevel_;
 }
 
 QTextStream &Debug::stream()
 {
-  return manager().stream_;
+  return Manager::line().stream_;
 }
 
 void Debug::flush(bool addEndLine)
@@ -168,11 +216,13 @@ bool Debug::setFile(const QString &path)
 
 QString Debug::filePath()
 {
+  QMutexLocker locker(&manager().fileMutex_);
   return QFileInfo(manager().file_).filePath();
 }
 
 QString Debug::dirPath()
 {
+  QMutexLocker locker(&manager().fileMutex_);
   return QFileInfo(manager().file_).path();
 }
 
@@ -26,10 +26,30 @@
 #include <QDebug>
 #include <QFile>
 
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
 namespace mzqt {
 
   /*! Singleton debugger class activated by environment variable
    * MZQT_DEBUG_LEVEL and MZQT_DEBUG_FILE
+   *
+   * The level and the file are shared, the request level and the message
+   * being built belong to the calling thread: interfaces running in
+   * different threads can log at the same time.
    */
 
   class Debug {
@@ -50,21 +70,21 @@ namespace mzqt {
       VERY_HIGH = 4
     };
 
-    static void flush(bool addEndLine = false);
-    static void setLevel(Level level);
-    static Level level();
-    static Level requestLevel();
-    static QTextStream &stream();
-    static bool setFile(const QString &path);
-    static QString filePath();
-    static QString dirPath();
-    static bool possible(Level requestLevel);
+    MZQTDLL_API static void flush(bool addEndLine = false);
+    MZQTDLL_API static void setLevel(Level level);
+    MZQTDLL_API static Level level();
+    MZQTDLL_API static Level requestLevel();
+    MZQTDLL_API static QTextStream &stream();
+    MZQTDLL_API static bool setFile(const QString &path);
+    MZQTDLL_API static QString filePath();
+    MZQTDLL_API static QString dirPath();
+    MZQTDLL_API static bool possible(Level requestLevel);
 
     template<typename T>
     Debug &operator<<(const T &t);
 
-    static Debug &dbg(Level level = LEVEL_UNDEFINED);
-    static QDebug msg();
+    MZQTDLL_API static Debug &dbg(Level level = LEVEL_UNDEFINED);
+    MZQTDLL_API static QDebug msg();
 
   private:
 
@@ -85,7 +105,7 @@ namespace mzqt {
   };
 
   //!< Manipulator like method
-  Debug &operator<<(Debug &d, Debug::Command c);
+  MZQTDLL_API Debug &operator<<(Debug &d, Debug::Command c);
 }
 
 template<typename T>
@@ -20,6 +20,10 @@
  */
 
 #include "InstrumentInterface.h"
+#include "Scan.h"
+#include "ScanVisitor.h"
+#include "ConversionCheckpoint.h"
+#include "Exception.h"
 
 using namespace mzqt;
 
@@ -51,8 +55,153 @@ InstrumentInterface::InstrumentInterface(void)
   curUVScanNum_ = -1;
   firstUVScanNumber_ = -1;
   lastUVScanNumber_ = -1;
+
+  hashScans_ = false;
+  headerOnly_ = false;
 }
 
 InstrumentInterface::~InstrumentInterface(void)
 {
+  detachPeakLoaders();
+}
+
+long InstrumentInterface::getScans(long first, long last,
+                                   std::vector<Scan*> &out)
+{
+  if (last < first)
+    return 0;
+
+  size_t size = out.size();
+  out.reserve(size + (last - first + 1));
+  for (long scanNumber = first; scanNumber <= last; ++scanNumber) {
+    progress_.checkCancelled();
+    Scan* scan = getScan(scanNumber);
+    if (scan != NULL)
+      out.push_back(scan);
+  }
+
+  return (long) (out.size() - size);
+}
+
+long InstrumentInterface::visitScans(ScanVisitor &visitor)
+{
+  ScanHeader header;
+  long numScans = 0;
+
+  Scan* scan;
+  while ((scan = getScan()) != NULL) {
+    header.assign(*scan);
+    // in header-only mode the peaks are only read if wanted
+    if (visitor.onHeader(header)) {
+      double *mz, *intensity;
+      scan->getMZArray(&mz);
+      scan->getIntensityArray(&intensity);
+      size_t size = scan->getNumDataPoints();
+      visitor.onPeaks(Span<const double>(mz, size), Span<const double>(
+          intensity, size));
+    }
+    delete scan;
+    numScans++;
+  }
+
+  return numScans;
+}
+
+void InstrumentInterface::saveState(ConversionCheckpoint &checkpoint) const
+{
+  checkpoint.setValue("accurateMasses", QString::number(accurateMasses_));
+  checkpoint.setValue("inaccurateMasses", QString::number(inaccurateMasses_));
+
+  QStringList chargeCounts;
+  for (size_t i = 0; i < chargeCounts_.size(); ++i)
+    chargeCounts << QString::number(chargeCounts_[i]);
+  checkpoint.setValue("chargeCounts", chargeCounts.join(" "));
+
+  if (hashScans_) {
+    checkpoint.setValue("duplicateScans", QString::number(
+        scanHasher_.duplicateScans_));
+    checkpoint.setValue("degenerateScans", QString::number(
+        scanHasher_.degenerateScans_));
+  }
+}
+
+void InstrumentInterface::restoreState(const ConversionCheckpoint &checkpoint)
+{
+  accurateMasses_ = checkpoint.value("accurateMasses", "0").toInt();
+  inaccurateMasses_ = checkpoint.value("inaccurateMasses", "0").toInt();
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+  QStringList chargeCounts = checkpoint.value("chargeCounts").split(' ',
+      Qt::SkipEmptyParts);
+#else
+  QStringList chargeCounts = checkpoint.value("chargeCounts").split(' ',
+      QString::SkipEmptyParts);
+#endif
+  if (!chargeCounts.isEmpty()) {
+    chargeCounts_.resize(chargeCounts.size());
+    for (int i = 0; i < chargeCounts.size(); ++i)
+      chargeCounts_[i] = chargeCounts[i].toInt();
+  }
+
+  if (hashScans_) {
+    scanHasher_.duplicateScans_ = checkpoint.value("duplicateScans",
+        "0").toLong();
+    scanHasher_.degenerateScans_ = checkpoint.value("degenerateScans",
+        "0").toLong();
+  }
+}
+
+void InstrumentInterface::setScanHashing(bool hash, bool dropDuplicates,
+                                         bool dropDegenerate)
+{
+  hashScans_ = hash;
+  scanHasher_.setDropDuplicates(dropDuplicates);
+  scanHasher_.setDropDegenerate(dropDegenerate);
+}
+
+void InstrumentInterface::setHeaderOnly(bool headerOnly)
+{
+  headerOnly_ = headerOnly;
+}
+
+std::function<void(Scan &)> InstrumentInterface::peakLoader(
+    const std::function<void(Scan &)> &load)
+{
+  if (!openFile_)
+    openFile_ = std::make_shared<bool>(true);
+  std::weak_ptr<bool> file = openFile_;
+  return [file, load](Scan &scan) {
+    if (file.expired())
+      throw Exception("the peaks of a header-only scan were read after "
+                      "its file was closed");
+    load(scan);
+  };
+}
+
+void InstrumentInterface::detachPeakLoaders(void)
+{
+  openFile_.reset();
+}
+
+void InstrumentInterface::setScanSelection(const ScanSelection &selection)
+{
+  selection_ = selection;
+}
+
+void InstrumentInterface::setProgressCallback(
+    const ProgressReporter::Callback &callback, long numScans, long ms)
+{
+  progress_.setCallback(callback);
+  progress_.setInterval(numScans, ms);
+}
+
+void InstrumentInterface::setCancellationToken(const CancellationToken *token)
+{
+  progress_.setCancellationToken(token);
+}
+
+void InstrumentInterface::checkScanContent(Scan &scan)
+{
+  if (hashScans_)
+    scanHasher_.check(scan);
 }
@@ -29,12 +29,33 @@
 #define MZQT_INSTRUMENTINTERFACE_H_
 
 
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include <QString>
 #include <QObject>
 
 #include "InstrumentInfo.h"
+#include "ScanHasher.h"
+#include "ScanSelection.h"
+#include "Progress.h"
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
 
 //typedef to allow to work with both XRawFile and XRawFileWrapper file api
 #ifdef MZQT_XRAWFILE_WRAPPER
@@ -53,8 +74,11 @@ namespace mzqt {
 
   class Scan;
   class UVScan;
+  class ScanVisitor;
+  class ConversionCheckpoint;
 
-  class InstrumentInterface : public QObject {
+  // exported as a whole: the backend plugins need its meta-object
+  class MZQTDLL_API InstrumentInterface : public QObject {
 
   public:
 
@@ -91,6 +115,20 @@ namespace mzqt {
 
     InstrumentInfo instrumentInfo_;
 
+    // content hashing of the scans, off by default
+    bool hashScans_;
+    ScanHasher scanHasher_;
+
+    // header-only reading, off by default
+    bool headerOnly_;
+
+    // scans returned by getScan(void), all by default
+    ScanSelection selection_;
+
+    // throttled progress and cancellation of the preprocessing and reading
+    // loops
+    ProgressReporter progress_;
+
   public:
     InstrumentInterface(void);
 
@@ -106,6 +144,73 @@ namespace mzqt {
     virtual void setVerbose(bool verbose) = 0;
     virtual Scan* getScan(void) = 0; // returns next available scan (first, initally)
     virtual UVScan *getUVScan(void); // returns next available UV scan (first, initally)
+
+    //! \brief read the scan with native scan number scanNumber, NULL if there
+    //! is no such scan. The position of getScan(void) is not changed
+    virtual Scan* getScan(long scanNumber);
+    //! \brief make scanNumber the next scan returned by getScan(void),
+    //! returns false if there is no such scan
+    virtual bool seek(long scanNumber);
+    //! \brief append the scans first to last (included) to out, returns the
+    //! number of scans appended. Like getScan(scanNumber), the position of
+    //! getScan(void) and the selection are not taken into account
+    virtual long getScans(long first, long last, std::vector<Scan*> &out);
+    //! \brief give the next scans to visitor without keeping them, returns
+    //! the number of scans visited. The default version builds a Scan for
+    //! each of them
+    virtual long visitScans(ScanVisitor &visitor);
+
+    //! \brief true while the file is still being written by the instrument
+    virtual bool inAcquisition(void);
+    //! \brief look for the scans written since the file was opened or last
+    //! refreshed, returns true if lastScanNumber_ has grown. getScan(void)
+    //! then goes on with the new scans
+    virtual bool refreshScanCount(void);
+
+    //! \brief store in checkpoint the counters updated while reading, so
+    //! that a resumed conversion reports the same figures. The content
+    //! hashes of the scans already read are not stored
+    virtual void saveState(ConversionCheckpoint &checkpoint) const;
+    virtual void restoreState(const ConversionCheckpoint &checkpoint);
+
+    //! \brief hash the peaks of each scan read to flag duplicate and
+    //! degenerate spectra, optionally dropping their peaks
+    void setScanHashing(bool hash, bool dropDuplicates = false,
+                        bool dropDegenerate = false);
+
+    //! \brief read only the scan headers: the peaks of the returned scans
+    //! are read on first access. Their loader keeps no reference to the
+    //! file: once the interface is destroyed or opens another file, reading
+    //! the peaks of such a scan throws Exception
+    void setHeaderOnly(bool headerOnly);
+
+    //! \brief skip the scans not accepted by selection in getScan(void).
+    //! Random access with getScan(scanNumber) is not affected
+    void setScanSelection(const ScanSelection &selection);
+
+    //! \brief give the progress to callback every numScans scans or every
+    //! ms milliseconds while preprocessing and reading
+    void setProgressCallback(const ProgressReporter::Callback &callback,
+                             long numScans = 1000, long ms = 250);
+
+    //! \brief the preprocessing and reading loops throw Abort once token is
+    //! cancelled. The token is not owned, NULL to stop checking
+    void setCancellationToken(const CancellationToken *token);
+
+  protected:
+    //! \brief to be called by getScan() once the peaks of scan are read
+    void checkScanContent(Scan &scan);
+
+    //! \brief the loader to give to Scan::setPeakLoader(): it calls load
+    //! until detachPeakLoaders()
+    std::function<void(Scan &)> peakLoader(
+        const std::function<void(Scan &)> &load);
+    //! \brief to be called before the file is closed or replaced
+    void detachPeakLoaders(void);
+
+  private:
+    // expires with the file read by the peak loaders given out
+    std::shared_ptr<bool> openFile_;
   };
 
 }
@@ -115,4 +220,24 @@ inline mzqt::UVScan *mzqt::InstrumentInterface::getUVScan(void)
   return NULL;
 }
 
+inline mzqt::Scan *mzqt::InstrumentInterface::getScan(long /*scanNumber*/)
+{
+  return NULL;
+}
+
+inline bool mzqt::InstrumentInterface::seek(long /*scanNumber*/)
+{
+  return false;
+}
+
+inline bool mzqt::InstrumentInterface::inAcquisition(void)
+{
+  return false;
+}
+
+inline bool mzqt::InstrumentInterface::refreshScanCount(void)
+{
+  return false;
+}
+
 #endif /* MZQT_INSTRUMENTINTERFACE_H_ */
@@ -0,0 +1,64 @@
+/*
+ InstrumentInterfacePlugin.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_INSTRUMENTINTERFACEPLUGIN_H_
+#define MZQT_INSTRUMENTINTERFACEPLUGIN_H_
+
+#include <QString>
+#include <QtPlugin>
+
+namespace mzqt {
+
+  class InstrumentInterface;
+
+  /*! Factory of one InstrumentInterface backend, implemented by the vendor
+   * plugins loaded at runtime by BackendRegistry.
+   *
+   * The plugins are built apart from the core library: the core does not
+   * depend on COM or on the vendor libraries and the backends available
+   * on a machine are the plugins installed there.
+   */
+  class InstrumentInterfacePlugin {
+
+  public:
+    virtual ~InstrumentInterfacePlugin()
+    {
+    }
+
+    //! \brief short name used to select the backend, like "thermo"
+    virtual QString name() const = 0;
+    //! \brief true if fileName looks like a file of this backend, without
+    //! opening it
+    virtual bool canRead(const QString &fileName) const = 0;
+    //! \brief new interface owned by the caller, who calls initInterface()
+    //! and setInputFile() as usual
+    virtual InstrumentInterface *create() = 0;
+  };
+
+}
+
+#define MZQT_INSTRUMENTINTERFACEPLUGIN_IID \
+    "com.moldiscovery.mzqt.InstrumentInterfacePlugin/1.0"
+
+Q_DECLARE_INTERFACE(mzqt::InstrumentInterfacePlugin,
+    MZQT_INSTRUMENTINTERFACEPLUGIN_IID)
+
+#endif /* MZQT_INSTRUMENTINTERFACEPLUGIN_H_ */
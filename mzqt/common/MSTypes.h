@@ -29,6 +29,22 @@
 
 #include <string>
 
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
 namespace mzqt {
 
     typedef enum {
@@ -39,8 +55,8 @@ namespace mzqt {
         ABI_SCIEX,
         AGILENT
     } MSManufacturerType;
-    std::string toString(MSManufacturerType manufacturer);
-    std::string toOBO(MSManufacturerType manufacturer);
+    MZQTDLL_API std::string toString(MSManufacturerType manufacturer);
+    MZQTDLL_API std::string toOBO(MSManufacturerType manufacturer);
 
     typedef enum {
         INSTRUMENTMODEL_UNDEF = 0,
@@ -101,8 +117,8 @@ namespace mzqt {
         API_QSTAR_PULSAR_I,
         QSTAR_XL_SYSTEM,
     } MSInstrumentModelType;
-    std::string toString(MSInstrumentModelType instrumentModel);
-    std::string toOBO(MSInstrumentModelType instrumentModel);
+    MZQTDLL_API std::string toString(MSInstrumentModelType instrumentModel);
+    MZQTDLL_API std::string toOBO(MSInstrumentModelType instrumentModel);
 
     typedef enum {
         ACQUISITIONSOFTWARE_UNDEF = 0,
@@ -112,8 +128,8 @@ namespace mzqt {
         ANALYSTQS,
         MASSHUNTER
     } MSAcquisitionSoftwareType;
-    std::string toString(MSAcquisitionSoftwareType acquisitionSoftware);
-    std::string toOBO(MSAcquisitionSoftwareType acquisitionSoftware);
+    MZQTDLL_API std::string toString(MSAcquisitionSoftwareType acquisitionSoftware);
+    MZQTDLL_API std::string toOBO(MSAcquisitionSoftwareType acquisitionSoftware);
 
     typedef enum {
         ANALYZER_UNDEF = 0,
@@ -135,17 +151,17 @@ namespace mzqt {
         TANDEM_QUAD,
     // tandem quadrupole
     } MSAnalyzerType;
-    std::string toString(MSAnalyzerType analyzer);
-    std::string toOBO(MSAnalyzerType analyzer);
-    std::string toOBOText(MSAnalyzerType analyzer);
-    MSAnalyzerType MSAnalyzerTypeFromString(const std::string &analyzer);
+    MZQTDLL_API std::string toString(MSAnalyzerType analyzer);
+    MZQTDLL_API std::string toOBO(MSAnalyzerType analyzer);
+    MZQTDLL_API std::string toOBOText(MSAnalyzerType analyzer);
+    MZQTDLL_API MSAnalyzerType MSAnalyzerTypeFromString(const std::string &analyzer);
 
     typedef enum {
         DETECTOR_UNDEF = 0,
     } MSDetectorType;
-    std::string toString(MSDetectorType detector);
-    std::string toOBO(MSDetectorType detector);
-    MSDetectorType MSDetectorTypeFromString(const std::string &detector);
+    MZQTDLL_API std::string toString(MSDetectorType detector);
+    MZQTDLL_API std::string toOBO(MSDetectorType detector);
+    MZQTDLL_API MSDetectorType MSDetectorTypeFromString(const std::string &detector);
 
     typedef enum {
         POLARITY_UNDEF = 0, POSITIVE, NEGATIVE, ANY
@@ -180,10 +196,10 @@ namespace mzqt {
         // assuming NSI is equivilent to nanospray ESI
         MS_CHIP
     } MSIonizationType;
-    std::string toString(MSIonizationType ionization);
-    std::string toOBO(MSIonizationType ionization);
-    std::string toOBOText(MSIonizationType ionization);
-    MSIonizationType MSIonizationTypeFromString(const std::string &ionization);
+    MZQTDLL_API std::string toString(MSIonizationType ionization);
+    MZQTDLL_API std::string toOBO(MSIonizationType ionization);
+    MZQTDLL_API std::string toOBOText(MSIonizationType ionization);
+    MZQTDLL_API MSIonizationType MSIonizationTypeFromString(const std::string &ionization);
 
     typedef enum {
         SCAN_UNDEF = 0,
@@ -232,9 +248,9 @@ namespace mzqt {
         SelectedIon,
         TotalIon,
     } MSScanType;
-    std::string toString(MSScanType scanType);
-    std::string toOBO(MSScanType scanType);
-    std::string toOBOText(MSScanType scanType);
+    MZQTDLL_API std::string toString(MSScanType scanType);
+    MZQTDLL_API std::string toOBO(MSScanType scanType);
+    MZQTDLL_API std::string toOBOText(MSScanType scanType);
 
     typedef enum {
         ACTIVATION_UNDEF = 0,
@@ -256,10 +272,10 @@ namespace mzqt {
 
     // added for Agilent MassHunter
     } MSActivationType;
-    std::string toString(MSActivationType activation);
-    std::string toOBO(MSActivationType activation);
-    std::string toOBOText(MSActivationType activation);
-    MSActivationType MSActivationTypeFromString(const std::string &activation);
+    MZQTDLL_API std::string toString(MSActivationType activation);
+    MZQTDLL_API std::string toOBO(MSActivationType activation);
+    MZQTDLL_API std::string toOBOText(MSActivationType activation);
+    MZQTDLL_API MSActivationType MSActivationTypeFromString(const std::string &activation);
 
     typedef enum {
         SCAN_COORDINATE_UNDEF = 0,
@@ -282,7 +298,7 @@ namespace mzqt {
         MHDAC_COORDINATE_NATIVESCANNUM
 
     } ScanCoordinateType;
-    std::string toString(ScanCoordinateType scanCoordinateType);
+    MZQTDLL_API std::string toString(ScanCoordinateType scanCoordinateType);
 
 }
 
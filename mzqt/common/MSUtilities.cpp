@@ -29,7 +29,6 @@
 
 #include <sstream>
 #include <iomanip>
-#include <tchar.h> // for _stprintf
 #include <cctype> // for toupper, tolower
 #include <algorithm> // for transform
 using namespace std;
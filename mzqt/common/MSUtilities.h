@@ -30,21 +30,37 @@
 
 #include <string>
 
-std::string convertToURI(const std::string& filename,
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+MZQTDLL_API std::string convertToURI(const std::string& filename,
         const std::string& hostname);
 
 // ex ID string: urn:lsid:unknown.org:OGDEN_c_thermotest_1min.mzML
-std::string convertToIDString(const std::string& filename,
+MZQTDLL_API std::string convertToIDString(const std::string& filename,
         const std::string& hostname);
 
-std::string toString(long value, int precision = -1);
-std::string toString(int value, int precision = -1);
-std::string toString(double value, int precision = -1);
-std::string toString(float value, int precision = -1);
+MZQTDLL_API std::string toString(long value, int precision = -1);
+MZQTDLL_API std::string toString(int value, int precision = -1);
+MZQTDLL_API std::string toString(double value, int precision = -1);
+MZQTDLL_API std::string toString(float value, int precision = -1);
 
-std::string toUpper(const std::string& str);
-std::string toLower(const std::string& str);
-double toDouble(const std::string& string);
-int toInt(const std::string& string);
+MZQTDLL_API std::string toUpper(const std::string& str);
+MZQTDLL_API std::string toLower(const std::string& str);
+MZQTDLL_API double toDouble(const std::string& string);
+MZQTDLL_API int toInt(const std::string& string);
 
 #endif
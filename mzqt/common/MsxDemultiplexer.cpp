@@ -0,0 +1,412 @@
+/*
+ MsxDemultiplexer.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <thread>
+#include <utility>
+
+#include "MsxDemultiplexer.h"
+#include "Scan.h"
+#include "Debug.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+namespace {
+
+  //! solve the n x n system a x = b in place (a and b are destroyed),
+  //! singular directions are left to 0
+  void solve(std::vector<double> &a, std::vector<double> &b, int n,
+             std::vector<double> &x)
+  {
+    for (int col = 0; col < n; ++col) {
+      int pivot = col;
+      for (int row = col + 1; row < n; ++row)
+        if (std::fabs(a[row * n + col]) > std::fabs(a[pivot * n + col]))
+          pivot = row;
+      if (pivot != col) {
+        for (int k = 0; k < n; ++k)
+          std::swap(a[col * n + k], a[pivot * n + k]);
+        std::swap(b[col], b[pivot]);
+      }
+      if (std::fabs(a[col * n + col]) < 1.0e-12)
+        continue;
+      for (int row = col + 1; row < n; ++row) {
+        double f = a[row * n + col] / a[col * n + col];
+        for (int k = col; k < n; ++k)
+          a[row * n + k] -= f * a[col * n + k];
+        b[row] -= f * b[col];
+      }
+    }
+
+    x.assign(n, 0.0);
+    for (int row = n - 1; row >= 0; --row) {
+      if (std::fabs(a[row * n + row]) < 1.0e-12)
+        continue;
+      double sum = b[row];
+      for (int k = row + 1; k < n; ++k)
+        sum -= a[row * n + k] * x[k];
+      x[row] = sum / a[row * n + row];
+    }
+  }
+
+}
+
+//! buffers reused by a worker thread for all the scans of its blocks
+struct MsxDemultiplexer::Workspace {
+  std::vector<double> precursors; //!< distinct precursors of the neighbors
+  std::vector<const Scan *> neighbors;
+  std::vector<std::pair<int, int> > isolated; //!< (neighbor, precursor)
+  std::vector<char> design; //!< neighbors x precursors, 1 if isolated
+  std::vector<double> gram; //!< design' design
+  std::vector<double> rhs; //!< design' observed
+  std::vector<double> observed;
+  std::vector<double> x, z, w, a, b, s;
+  std::vector<char> passive;
+  std::vector<int> passiveIndex;
+
+  int precursorIndex(double mz, double tolerance)
+  {
+    for (size_t p = 0; p < precursors.size(); ++p)
+      if (std::fabs(precursors[p] - mz) <= tolerance)
+        return (int) p;
+    precursors.push_back(mz);
+    return (int) precursors.size() - 1;
+  }
+
+  //! Lawson-Hanson non-negative least squares on the normal equations:
+  //! minimise |design x - observed| with x >= 0, given gram and rhs
+  void nnls(int n)
+  {
+    x.assign(n, 0.0);
+    passive.assign(n, 0);
+    w = rhs;
+
+    for (int iteration = 0; iteration < 3 * n; ++iteration) {
+      int best = -1;
+      for (int j = 0; j < n; ++j)
+        if (!passive[j] && w[j] > 1.0e-10 && (best < 0 || w[j] > w[best]))
+          best = j;
+      if (best < 0)
+        break;
+      passive[best] = 1;
+
+      while (true) {
+        passiveIndex.clear();
+        for (int j = 0; j < n; ++j)
+          if (passive[j])
+            passiveIndex.push_back(j);
+        int np = (int) passiveIndex.size();
+
+        a.resize(np * np);
+        b.resize(np);
+        for (int r = 0; r < np; ++r) {
+          b[r] = rhs[passiveIndex[r]];
+          for (int c = 0; c < np; ++c)
+            a[r * np + c] = gram[passiveIndex[r] * n + passiveIndex[c]];
+        }
+        solve(a, b, np, s);
+
+        z.assign(n, 0.0);
+        bool feasible = true;
+        for (int r = 0; r < np; ++r) {
+          z[passiveIndex[r]] = s[r];
+          if (s[r] <= 0)
+            feasible = false;
+        }
+        if (feasible) {
+          x = z;
+          break;
+        }
+
+        // move toward z until a passive variable reaches 0
+        double alpha = 1.0;
+        for (int r = 0; r < np; ++r) {
+          int j = passiveIndex[r];
+          if (z[j] <= 0)
+            alpha = std::min(alpha, x[j] / (x[j] - z[j]));
+        }
+        for (int j = 0; j < n; ++j) {
+          x[j] += alpha * (z[j] - x[j]);
+          if (passive[j] && x[j] <= 1.0e-12) {
+            x[j] = 0;
+            passive[j] = 0;
+          }
+        }
+      }
+
+      for (int j = 0; j < n; ++j) {
+        double gx = 0;
+        for (int k = 0; k < n; ++k)
+          gx += gram[j * n + k] * x[k];
+        w[j] = rhs[j] - gx;
+      }
+    }
+  }
+};
+
+MsxDemultiplexer::MsxDemultiplexer() :
+  numNeighbors_(4), fragmentTolerance_(20.0), precursorTolerance_(0.01),
+      numThreads_(0), blockSize_(64)
+{
+}
+
+void MsxDemultiplexer::setNumNeighbors(int neighbors)
+{
+  numNeighbors_ = std::max(neighbors, 1);
+}
+
+void MsxDemultiplexer::setFragmentTolerance(double ppm)
+{
+  fragmentTolerance_ = ppm;
+}
+
+void MsxDemultiplexer::setPrecursorTolerance(double mz)
+{
+  precursorTolerance_ = mz;
+}
+
+void MsxDemultiplexer::setNumThreads(int threads)
+{
+  numThreads_ = std::max(threads, 0);
+}
+
+void MsxDemultiplexer::setBlockSize(int scans)
+{
+  blockSize_ = std::max(scans, 1);
+}
+
+bool MsxDemultiplexer::addScan(const Scan *scan)
+{
+  if (scan == NULL || !scan->msx_ || scan->cidParentMass_.empty())
+    return false;
+
+  scans_.push_back(scan);
+  return true;
+}
+
+void MsxDemultiplexer::clear()
+{
+  scans_.clear();
+}
+
+void MsxDemultiplexer::demultiplex(std::vector<Scan *> &demultiplexed)
+{
+  std::vector<std::vector<Precursor> > results(scans_.size());
+
+  // the peaks of header-only scans are read here: the backends are not
+  // thread-safe, and a neighbor is shared by the workers of several blocks
+  for (size_t i = 0; i < scans_.size(); ++i)
+    scans_[i]->loadPeaks();
+
+  int numThreads = numThreads_;
+  if (numThreads == 0)
+    numThreads = std::max(1, (int) std::thread::hardware_concurrency());
+  size_t numBlocks = (scans_.size() + blockSize_ - 1) / blockSize_;
+  numThreads = (int) std::min<size_t>(numThreads, numBlocks);
+
+  // blocks are handed out one at a time, each worker keeps its buffers.
+  // Workers only compute intensities: scans are built afterwards
+  std::atomic<size_t> nextBlock(0);
+  std::atomic<bool> failed(false);
+  std::exception_ptr error;
+
+  auto worker = [&]() {
+    Workspace work;
+    try {
+      size_t block;
+      while (!failed && (block = nextBlock++) < numBlocks) {
+        size_t last = std::min(scans_.size(), (block + 1) * blockSize_);
+        for (size_t i = block * blockSize_; i < last; ++i)
+          demultiplexScan(i, work, results[i]);
+      }
+    } catch (...) {
+      if (!failed.exchange(true))
+        error = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 1; t < numThreads; ++t)
+    threads.push_back(std::thread(worker));
+  if (numThreads > 0)
+    worker();
+  for (size_t t = 0; t < threads.size(); ++t)
+    threads[t].join();
+
+  if (error)
+    std::rethrow_exception(error);
+
+  size_t count = 0;
+  for (size_t i = 0; i < results.size(); ++i) {
+    for (size_t p = 0; p < results[i].size(); ++p) {
+      demultiplexed.push_back(buildScan(*scans_[i], results[i][p]));
+      ++count;
+    }
+  }
+
+  Debug::dbg(Debug::MEDIUM) << "demultiplexed " << scans_.size()
+      << " MSX scans into " << count << " scans" << Debug::ENDL;
+}
+
+void MsxDemultiplexer::demultiplexScan(size_t index, Workspace &work,
+    std::vector<Precursor> &result) const
+{
+  const Scan *target = scans_[index];
+
+  // neighbors of the same ms level, the target first
+  work.neighbors.clear();
+  work.neighbors.push_back(target);
+  size_t first = index > (size_t) numNeighbors_ ? index - numNeighbors_ : 0;
+  size_t last = std::min(scans_.size(), index + numNeighbors_ + 1);
+  for (size_t i = first; i < last; ++i)
+    if (i != index && scans_[i]->msLevel_ == target->msLevel_)
+      work.neighbors.push_back(scans_[i]);
+
+  // design matrix: which precursor is isolated in which neighbor. The
+  // precursors of the target come first
+  work.precursors.clear();
+  for (size_t j = 0; j < target->cidParentMass_.size(); ++j)
+    work.precursorIndex(target->cidParentMass_[j], precursorTolerance_);
+  int numTargetPrecursors = (int) work.precursors.size();
+
+  int m = (int) work.neighbors.size();
+  work.isolated.clear();
+  for (int i = 0; i < m; ++i) {
+    const Scan *neighbor = work.neighbors[i];
+    for (size_t j = 0; j < neighbor->cidParentMass_.size(); ++j)
+      work.isolated.push_back(std::make_pair(i, work.precursorIndex(
+          neighbor->cidParentMass_[j], precursorTolerance_)));
+  }
+
+  int n = (int) work.precursors.size();
+  work.design.assign(m * n, 0);
+  for (size_t k = 0; k < work.isolated.size(); ++k)
+    work.design[work.isolated[k].first * n + work.isolated[k].second] = 1;
+
+  // the design is the same for all the fragments of the scan
+  work.gram.assign(n * n, 0.0);
+  for (int i = 0; i < m; ++i)
+    for (int p = 0; p < n; ++p)
+      if (work.design[i * n + p])
+        for (int q = 0; q < n; ++q)
+          if (work.design[i * n + q])
+            work.gram[p * n + q] += 1.0;
+
+  int numPeaks = target->getNumDataPoints();
+  result.resize(numTargetPrecursors);
+  for (int p = 0; p < numTargetPrecursors; ++p) {
+    result[p].mz = work.precursors[p];
+    result[p].collisionEnergy = -1;
+    for (size_t j = 0; j < target->cidParentMass_.size(); ++j) {
+      if (std::fabs(target->cidParentMass_[j] - result[p].mz)
+          <= precursorTolerance_ && j < target->cidEnergy_.size()) {
+        result[p].collisionEnergy = target->cidEnergy_[j];
+        break;
+      }
+    }
+    result[p].intensity.assign(numPeaks, 0.0);
+  }
+
+  work.observed.resize(m);
+  work.rhs.resize(n);
+  for (int peak = 0; peak < numPeaks; ++peak) {
+    double mz = target->mzArray_[peak];
+    double delta = mz * fragmentTolerance_ * 1.0e-6;
+
+    // intensity of the fragment in each neighbor
+    work.observed[0] = target->intensityArray_[peak];
+    for (int i = 1; i < m; ++i) {
+      const Scan *neighbor = work.neighbors[i];
+      const double *begin = neighbor->mzArray_;
+      const double *end = begin + neighbor->getNumDataPoints();
+      double intensity = 0;
+      for (const double *it = std::lower_bound(begin, end, mz - delta); it
+          != end && *it <= mz + delta; ++it)
+        intensity = std::max(intensity, neighbor->intensityArray_[it - begin]);
+      work.observed[i] = intensity;
+    }
+
+    for (int p = 0; p < n; ++p) {
+      double sum = 0;
+      for (int i = 0; i < m; ++i)
+        if (work.design[i * n + p])
+          sum += work.observed[i];
+      work.rhs[p] = sum;
+    }
+
+    work.nnls(n);
+
+    // share the observed intensity among the precursors of the target
+    double total = 0;
+    for (int p = 0; p < numTargetPrecursors; ++p)
+      total += work.x[p];
+    if (total > 0)
+      for (int p = 0; p < numTargetPrecursors; ++p)
+        result[p].intensity[peak] = work.observed[0] * work.x[p] / total;
+  }
+}
+
+Scan *MsxDemultiplexer::buildScan(const Scan &target,
+    const Precursor &precursor) const
+{
+  Scan *scan = new Scan(target);
+  scan->msx_ = false;
+  scan->precursorMZ_ = precursor.mz;
+  scan->accuratePrecursorMZ_ = false;
+  scan->cidParentMass_.assign(1, precursor.mz);
+  if (precursor.collisionEnergy >= 0) {
+    scan->cidEnergy_.assign(1, precursor.collisionEnergy);
+    scan->collisionEnergy_ = precursor.collisionEnergy;
+  }
+
+  // keep the fragments assigned to this precursor
+  int kept = 0;
+  scan->totalIonCurrent_ = 0;
+  scan->basePeakMZ_ = -1;
+  scan->basePeakIntensity_ = 0;
+  for (size_t peak = 0; peak < precursor.intensity.size(); ++peak) {
+    double intensity = precursor.intensity[peak];
+    if (intensity <= 0)
+      continue;
+    scan->mzArray_[kept] = scan->mzArray_[peak];
+    scan->intensityArray_[kept] = intensity;
+    scan->totalIonCurrent_ += intensity;
+    if (intensity > scan->basePeakIntensity_) {
+      scan->basePeakMZ_ = scan->mzArray_[kept];
+      scan->basePeakIntensity_ = intensity;
+    }
+    ++kept;
+  }
+  scan->resetNumDataPoints(kept);
+  if (kept > 0) {
+    scan->minObservedMZ_ = scan->mzArray_[0];
+    scan->maxObservedMZ_ = scan->mzArray_[kept - 1];
+  }
+
+  return scan;
+}
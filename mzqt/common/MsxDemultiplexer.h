@@ -0,0 +1,111 @@
+/*
+ MsxDemultiplexer.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_MSXDEMULTIPLEXER_H_
+#define MZQT_MSXDEMULTIPLEXER_H_
+
+#include <vector>
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+namespace mzqt {
+
+  class Scan;
+
+  /*! Split multiplexed (MSX) scans into one scan per co-isolated precursor.
+   *
+   * Each MSX scan isolates several precursors, listed in
+   * Scan::cidParentMass_. Neighboring MSX scans isolate different
+   * combinations of precursors: assuming the fragment spectrum of a
+   * precursor does not change over a few scans, the intensity of each
+   * fragment in each neighbor is the sum of the contributions of its
+   * precursors. The contributions are found with non-negative least squares
+   * and the observed intensity of the fragment is shared accordingly.
+   *
+   * Scans are processed in blocks on several threads.
+   */
+  class MsxDemultiplexer {
+
+  public:
+    MZQTDLL_API MsxDemultiplexer();
+
+    //! \brief MSX scans used on each side of the demultiplexed scan
+    MZQTDLL_API void setNumNeighbors(int neighbors);
+    MZQTDLL_API void setFragmentTolerance(double ppm);
+    //! \brief tolerance used to recognise the same precursor in different
+    //! scans; filter line masses have two decimals
+    MZQTDLL_API void setPrecursorTolerance(double mz);
+    //! \brief number of worker threads, 0 means one per core
+    MZQTDLL_API void setNumThreads(int threads);
+    MZQTDLL_API void setBlockSize(int scans);
+
+    //! \brief register a MSX scan, in acquisition order. Returns false if the
+    //! scan is not multiplexed. The scan is not copied: it must stay alive
+    //! until demultiplex() returns
+    MZQTDLL_API bool addScan(const Scan *scan);
+    MZQTDLL_API void clear();
+
+    //! \brief append to demultiplexed one scan per precursor of each
+    //! registered scan, in acquisition order. The caller owns the returned
+    //! scans
+    MZQTDLL_API void demultiplex(std::vector<Scan *> &demultiplexed);
+
+  private:
+
+    struct Workspace;
+
+    //! fragment intensities of one precursor of a MSX scan
+    struct Precursor {
+      double mz;
+      double collisionEnergy;
+      std::vector<double> intensity; //!< one per peak of the MSX scan
+    };
+
+    void demultiplexScan(size_t index, Workspace &work,
+                         std::vector<Precursor> &result) const;
+    Scan *buildScan(const Scan &target, const Precursor &precursor) const;
+
+    int numNeighbors_;
+    double fragmentTolerance_; //!< ppm
+    double precursorTolerance_; //!< m/z
+    int numThreads_;
+    int blockSize_;
+
+    std::vector<const Scan *> scans_;
+  };
+
+}
+
+#endif /* MZQT_MSXDEMULTIPLEXER_H_ */
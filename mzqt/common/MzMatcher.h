@@ -0,0 +1,164 @@
+/*
+ MzMatcher.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_MZMATCHER_H_
+#define MZQT_MZMATCHER_H_
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace mzqt {
+
+  /*! Match a list of target m/z values against the peaks of a spectrum.
+   *
+   * Both the targets and the spectrum must be sorted by increasing m/z. The
+   * lower end of the tolerance window never decreases from a target to the
+   * next, so all the targets are matched in a single merge pass over the
+   * spectrum, without searching the spectrum for each target.
+   *
+   * Containers can be anything indexable with operator[] and size(): plain
+   * arrays are wrapped with MzMatcher::Array.
+   */
+  class MzMatcher {
+
+  public:
+    //! peak kept by match() when several are in the window
+    enum Mode {
+      MOST_INTENSE, CLOSEST
+    };
+
+    struct Match {
+      size_t target;
+      size_t peak;
+    };
+
+    //! read only view of a C array
+    template<typename T>
+    struct Array {
+      const T *data;
+      size_t count;
+
+      Array(const T *d, size_t n) :
+        data(d), count(n)
+      {
+      }
+      const T &operator[](size_t i) const
+      {
+        return data[i];
+      }
+      size_t size() const
+      {
+        return count;
+      }
+    };
+
+    MzMatcher() :
+      tolerance_(10.0), ppm_(true)
+    {
+    }
+
+    void setPPMTolerance(double ppm)
+    {
+      tolerance_ = ppm;
+      ppm_ = true;
+    }
+
+    void setAbsoluteTolerance(double mz)
+    {
+      tolerance_ = mz;
+      ppm_ = false;
+    }
+
+    double tolerance(double mz) const
+    {
+      return ppm_ ? mz * tolerance_ * 1.0e-6 : tolerance_;
+    }
+
+    //! \brief for each target, index of the most intense or closest peak
+    //! within tolerance, -1 if none
+    template<class Targets, class MZs, class Intensities>
+    void match(const Targets &targets, const MZs &mz,
+               const Intensities &intensity, Mode mode,
+               std::vector<long> &peaks) const
+    {
+      peaks.assign(targets.size(), -1);
+      size_t start = 0, size = mz.size();
+      for (size_t t = 0; t < targets.size(); ++t) {
+        double target = targets[t], delta = tolerance(target);
+        while (start < size && mz[start] < target - delta)
+          ++start;
+
+        double best = 0;
+        for (size_t j = start; j < size && mz[j] <= target + delta; ++j) {
+          double score = mode == CLOSEST ? -std::fabs(mz[j] - target)
+              : (double) intensity[j];
+          if (peaks[t] < 0 || score > best) {
+            peaks[t] = (long) j;
+            best = score;
+          }
+        }
+      }
+    }
+
+    //! \brief for each target, sum of the intensities within tolerance
+    template<class Targets, class MZs, class Intensities>
+    void sum(const Targets &targets, const MZs &mz,
+             const Intensities &intensity, std::vector<double> &sums) const
+    {
+      sums.assign(targets.size(), 0.0);
+      size_t start = 0, size = mz.size();
+      for (size_t t = 0; t < targets.size(); ++t) {
+        double target = targets[t], delta = tolerance(target);
+        while (start < size && mz[start] < target - delta)
+          ++start;
+        for (size_t j = start; j < size && mz[j] <= target + delta; ++j)
+          sums[t] += intensity[j];
+      }
+    }
+
+    //! \brief every (target, peak) pair within tolerance, by target then
+    //! peak. A peak can match several targets
+    template<class Targets, class MZs>
+    void matchAll(const Targets &targets, const MZs &mz,
+                  std::vector<Match> &matches) const
+    {
+      matches.clear();
+      size_t start = 0, size = mz.size();
+      for (size_t t = 0; t < targets.size(); ++t) {
+        double target = targets[t], delta = tolerance(target);
+        while (start < size && mz[start] < target - delta)
+          ++start;
+        for (size_t j = start; j < size && mz[j] <= target + delta; ++j) {
+          Match m = { t, j };
+          matches.push_back(m);
+        }
+      }
+    }
+
+  private:
+    double tolerance_;
+    bool ppm_;
+  };
+
+}
+
+#endif /* MZQT_MZMATCHER_H_ */
@@ -0,0 +1,191 @@
+/*
+ PrecursorCorrector.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cmath>
+#include <climits>
+
+#include "PrecursorCorrector.h"
+#include "Scan.h"
+#include "Debug.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+namespace {
+
+  //! the envelope is only followed this far above the precursor
+  const int MAX_FORWARD_ISOTOPES = 4;
+
+}
+
+PrecursorCorrector::PrecursorCorrector() :
+  correctedMasses_(0), assignedCharges_(0), missingParents_(0),
+      tolerance_(10.0), maxCharge_(6), maxIsotopeShift_(3),
+      minIsotopeRatio_(0.05), overwriteCharge_(false), cache_(4)
+{
+}
+
+void PrecursorCorrector::setTolerance(double ppm)
+{
+  tolerance_ = ppm;
+}
+
+void PrecursorCorrector::setMaxCharge(int charge)
+{
+  maxCharge_ = charge;
+}
+
+void PrecursorCorrector::setMaxIsotopeShift(int shift)
+{
+  maxIsotopeShift_ = shift;
+}
+
+void PrecursorCorrector::setMinIsotopeRatio(double ratio)
+{
+  minIsotopeRatio_ = ratio;
+}
+
+void PrecursorCorrector::setOverwriteCharge(bool overwrite)
+{
+  overwriteCharge_ = overwrite;
+}
+
+void PrecursorCorrector::setCacheSize(size_t size)
+{
+  cache_.setCapacity(size);
+}
+
+SpectrumCache &PrecursorCorrector::cache()
+{
+  return cache_;
+}
+
+void PrecursorCorrector::addScan(Scan &scan)
+{
+  if (scan.msLevel_ == 1)
+    cache_.insert(scan);
+  else if (scan.msLevel_ > 1)
+    correct(scan);
+}
+
+const CachedSpectrum *PrecursorCorrector::parentSpectrum(const Scan &scan)
+{
+  if (scan.precursorScanNumber_ > 0)
+    return cache_.find(scan.precursorScanNumber_);
+
+  // no parent given by the vendor: closest MS1 read before this scan
+  return cache_.findPrevious(scan.scanNumber_ >= 0 ? scan.scanNumber_
+      : LONG_MAX);
+}
+
+long PrecursorCorrector::findPeak(const CachedSpectrum &spectrum, double mz) const
+{
+  double delta = mz * tolerance_ * 1.0e-6;
+  return spectrum.mostIntensePeak(mz - delta, mz + delta);
+}
+
+bool PrecursorCorrector::correct(Scan &scan)
+{
+  if (scan.msLevel_ < 2 || scan.precursorMZ_ <= 0)
+    return false;
+
+  const CachedSpectrum *parent = parentSpectrum(scan);
+  if (parent == NULL) {
+    missingParents_++;
+    return false;
+  }
+
+  long precursorPeak = findPeak(*parent, scan.precursorMZ_);
+  if (precursorPeak < 0)
+    return false;
+
+  double precursorMZ = parent->mz_[precursorPeak];
+
+  int minCharge = 1, maxCharge = maxCharge_;
+  if (scan.precursorCharge_ > 0 && !overwriteCharge_)
+    minCharge = maxCharge = scan.precursorCharge_;
+
+  int bestCharge = -1;
+  int bestPeaks = 1; // at least one isotope is needed to get a charge
+  double bestIntensity = 0;
+  long bestMonoPeak = precursorPeak;
+
+  for (int z = minCharge; z <= maxCharge; ++z) {
+    double spacing = ISOTOPE_SPACING / z;
+    double envelopeIntensity = parent->intensity_[precursorPeak];
+    int numPeaks = 1;
+
+    // follow the envelope above the precursor
+    for (int k = 1; k <= MAX_FORWARD_ISOTOPES; ++k) {
+      long peak = findPeak(*parent, precursorMZ + k * spacing);
+      if (peak < 0)
+        break;
+      envelopeIntensity += parent->intensity_[peak];
+      numPeaks++;
+    }
+
+    // walk down to the monoisotopic peak
+    long monoPeak = precursorPeak;
+    for (int k = 1; k <= maxIsotopeShift_; ++k) {
+      long peak = findPeak(*parent, precursorMZ - k * spacing);
+      if (peak < 0 || parent->intensity_[peak] < minIsotopeRatio_
+          * parent->intensity_[monoPeak])
+        break;
+      envelopeIntensity += parent->intensity_[peak];
+      numPeaks++;
+      monoPeak = peak;
+    }
+
+    // harmonics (2z for z) miss every other peak: they score less
+    if (numPeaks > bestPeaks || (numPeaks == bestPeaks && numPeaks > 1
+        && envelopeIntensity > bestIntensity)) {
+      bestCharge = z;
+      bestPeaks = numPeaks;
+      bestIntensity = envelopeIntensity;
+      bestMonoPeak = monoPeak;
+    }
+  }
+
+  if (bestCharge < 0)
+    return false;
+
+  bool changed = false;
+
+  if (bestMonoPeak != precursorPeak) {
+    Debug::dbg(Debug::HIGH) << "scan " << scan.scanNumber_
+        << " monoisotopic precursor moved from " << scan.precursorMZ_
+        << " to " << parent->mz_[bestMonoPeak] << Debug::ENDL;
+    correctedMasses_++;
+    changed = true;
+  }
+  scan.precursorMZ_ = parent->mz_[bestMonoPeak];
+  scan.accuratePrecursorMZ_ = true;
+
+  if (scan.precursorCharge_ != bestCharge) {
+    scan.precursorCharge_ = bestCharge;
+    assignedCharges_++;
+    changed = true;
+  }
+
+  return changed;
+}
@@ -0,0 +1,83 @@
+/*
+ PrecursorCorrector.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef MZQT_PRECURSORCORRECTOR_H_
+#define MZQT_PRECURSORCORRECTOR_H_
+
+#include "SpectrumCache.h"
+
+namespace mzqt {
+
+  class Scan;
+
+  /*! Correct the precursor monoisotopic m/z and charge of MSn scans using
+   * the isotope envelope found in the parent MS1 scan.
+   *
+   * MS1 scans have to be given to addScan() as they are read so that the
+   * parent is found in memory. Typical use:
+   *
+   *   while ((scan = iface.getScan()) != NULL) {
+   *     corrector.addScan(*scan); // caches MS1, corrects MSn
+   *     ...
+   *   }
+   */
+  class PrecursorCorrector {
+
+  public:
+    MZQTDLL_API PrecursorCorrector();
+
+    MZQTDLL_API void setTolerance(double ppm);
+    MZQTDLL_API void setMaxCharge(int charge);
+    MZQTDLL_API void setMaxIsotopeShift(int shift);
+    MZQTDLL_API void setMinIsotopeRatio(double ratio);
+    MZQTDLL_API void setOverwriteCharge(bool overwrite);
+    MZQTDLL_API void setCacheSize(size_t size);
+
+    //! \brief cache MS1 scans, correct MSn scans
+    MZQTDLL_API void addScan(Scan &scan);
+
+    //! \brief correct a MSn scan from its cached parent, returns true if the
+    //! precursor m/z or charge has been changed
+    MZQTDLL_API bool correct(Scan &scan);
+
+    //! \brief parent MS1 spectrum of scan if cached, NULL otherwise
+    MZQTDLL_API const CachedSpectrum *parentSpectrum(const Scan &scan);
+
+    MZQTDLL_API SpectrumCache &cache();
+
+    int correctedMasses_; //!< precursor m/z moved to the monoisotopic peak
+    int assignedCharges_; //!< charges set or changed
+    int missingParents_; //!< MSn scans without cached parent
+
+  private:
+    long findPeak(const CachedSpectrum &spectrum, double mz) const;
+
+    double tolerance_; //!< ppm
+    int maxCharge_;
+    int maxIsotopeShift_;
+    double minIsotopeRatio_;
+    bool overwriteCharge_;
+
+    SpectrumCache cache_;
+  };
+
+}
+
+#endif /* MZQT_PRECURSORCORRECTOR_H_ */
@@ -0,0 +1,166 @@
+/*
+ PrecursorPurity.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <climits>
+
+#include "PrecursorPurity.h"
+#include "Scan.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+namespace {
+
+  //! the envelope is only followed this far above the precursor
+  const int MAX_ISOTOPES = 10;
+
+}
+
+PrecursorPurity::PrecursorPurity() :
+  missingParents_(0), tolerance_(10.0), defaultIsolationWidth_(2.0),
+      maxCharge_(6), cache_(4)
+{
+}
+
+void PrecursorPurity::setTolerance(double ppm)
+{
+  tolerance_ = ppm;
+}
+
+void PrecursorPurity::setDefaultIsolationWidth(double width)
+{
+  defaultIsolationWidth_ = width;
+}
+
+void PrecursorPurity::setMaxCharge(int charge)
+{
+  maxCharge_ = charge;
+}
+
+void PrecursorPurity::setCacheSize(size_t size)
+{
+  cache_.setCapacity(size);
+}
+
+SpectrumCache &PrecursorPurity::cache()
+{
+  return cache_;
+}
+
+void PrecursorPurity::addScan(Scan &scan)
+{
+  if (scan.msLevel_ == 1)
+    cache_.insert(scan);
+  else if (scan.msLevel_ > 1)
+    compute(scan);
+}
+
+bool PrecursorPurity::compute(Scan &scan)
+{
+  if (scan.msLevel_ < 2 || scan.precursorMZ_ <= 0)
+    return false;
+
+  const CachedSpectrum *parent;
+  if (scan.precursorScanNumber_ > 0)
+    parent = cache_.find(scan.precursorScanNumber_);
+  else
+    parent = cache_.findPrevious(scan.scanNumber_ >= 0 ? scan.scanNumber_
+        : LONG_MAX);
+
+  if (parent == NULL) {
+    missingParents_++;
+    return false;
+  }
+
+  return compute(scan, *parent);
+}
+
+bool PrecursorPurity::compute(Scan &scan, const CachedSpectrum &parent) const
+{
+  if (scan.precursorMZ_ <= 0)
+    return false;
+
+  double width = scan.isolationWindow_ > 0 ? scan.isolationWindow_
+      : defaultIsolationWidth_;
+  scan.precursorPurity_ = purity(parent, scan.precursorMZ_,
+                                 scan.precursorCharge_, width);
+
+  return true;
+}
+
+double PrecursorPurity::purity(const CachedSpectrum &parent, double mz,
+    int charge, double width) const
+{
+  // the window is located by binary search, then read once per charge
+  size_t first = parent.lowerBound(mz - width / 2);
+  size_t last = parent.lowerBound(mz + width / 2);
+
+  double total = 0;
+  for (size_t i = first; i < last; ++i)
+    total += parent.intensity_[i];
+  if (total <= 0)
+    return 0;
+
+  double envelope = 0;
+  if (charge > 0) {
+    followEnvelope(parent, first, last, mz, charge, envelope);
+  } else {
+    // as in PrecursorCorrector: the charge explaining the most consecutive
+    // isotopes, a harmonic (2z for z) stops at the first peak it misses
+    int bestPeaks = 0;
+    for (int z = 1; z <= maxCharge_; ++z) {
+      double intensity;
+      int numPeaks = followEnvelope(parent, first, last, mz, z, intensity);
+      if (numPeaks > bestPeaks || (numPeaks == bestPeaks
+          && intensity > envelope)) {
+        bestPeaks = numPeaks;
+        envelope = intensity;
+      }
+    }
+  }
+
+  return envelope / total;
+}
+
+int PrecursorPurity::followEnvelope(const CachedSpectrum &parent, size_t first,
+    size_t last, double mz, int charge, double &intensity) const
+{
+  double spacing = ISOTOPE_SPACING / charge;
+  double delta = mz * tolerance_ * 1.0e-6;
+
+  intensity = 0;
+  int numPeaks = 0;
+  for (int k = 0; k <= MAX_ISOTOPES; ++k) {
+    double target = mz + k * spacing;
+    long peak = parent.mostIntensePeak(target - delta, target + delta);
+    if (peak < (long) first || peak >= (long) last)
+      break;
+    intensity += parent.intensity_[peak];
+    numPeaks++;
+  }
+
+  return numPeaks;
+}
@@ -0,0 +1,84 @@
+/*
+ PrecursorPurity.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_PRECURSORPURITY_H_
+#define MZQT_PRECURSORPURITY_H_
+
+#include "SpectrumCache.h"
+
+namespace mzqt {
+
+  class Scan;
+
+  /*! Compute the purity of the precursor of MSn scans: the fraction of the
+   * parent MS1 intensity inside the isolation window which belongs to the
+   * isotope envelope of the precursor.
+   *
+   * The isolation window is centred on the precursor m/z and is
+   * Scan::isolationWindow_ wide, or the default width when the scan does not
+   * report it. As for PrecursorCorrector, MS1 scans have to be given to
+   * addScan() as they are read.
+   */
+  class PrecursorPurity {
+
+  public:
+    MZQTDLL_API PrecursorPurity();
+
+    MZQTDLL_API void setTolerance(double ppm);
+    MZQTDLL_API void setDefaultIsolationWidth(double width);
+    MZQTDLL_API void setMaxCharge(int charge);
+    MZQTDLL_API void setCacheSize(size_t size);
+
+    //! \brief cache MS1 scans, compute the purity of MSn scans
+    MZQTDLL_API void addScan(Scan &scan);
+
+    //! \brief set Scan::precursorPurity_ from the cached parent, returns
+    //! false if the parent is not available
+    MZQTDLL_API bool compute(Scan &scan);
+    MZQTDLL_API bool compute(Scan &scan, const CachedSpectrum &parent) const;
+
+    //! \brief purity of the precursor mz with charge in a window of width
+    //! centred on mz. The envelope is the precursor peak and the isotopes
+    //! following it up to the first one missing. When charge is unknown
+    //! (<= 0) the charge with the longest envelope is used
+    MZQTDLL_API double purity(const CachedSpectrum &parent, double mz,
+        int charge, double width) const;
+
+    MZQTDLL_API SpectrumCache &cache();
+
+    int missingParents_; //!< MSn scans without cached parent
+
+  private:
+    //! \brief number of peaks of the envelope, 0 if the precursor peak is
+    //! not in the window
+    int followEnvelope(const CachedSpectrum &parent, size_t first,
+        size_t last, double mz, int charge, double &intensity) const;
+
+    double tolerance_; //!< ppm
+    double defaultIsolationWidth_;
+    int maxCharge_;
+
+    SpectrumCache cache_;
+  };
+
+}
+
+#endif /* MZQT_PRECURSORPURITY_H_ */
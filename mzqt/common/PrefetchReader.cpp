@@ -0,0 +1,176 @@
+/*
+ PrefetchReader.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "PrefetchReader.h"
+#include "InstrumentInterface.h"
+#include "Scan.h"
+#include "Debug.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+PrefetchReader::PrefetchReader(InstrumentInterface &iface, size_t depth) :
+  producerWaits_(0), consumerWaits_(0), iface_(iface), depth_(depth),
+      stop_(false), done_(true)
+{
+}
+
+PrefetchReader::~PrefetchReader()
+{
+  stop();
+}
+
+void PrefetchReader::setDepth(size_t depth)
+{
+  depth_ = depth;
+}
+
+size_t PrefetchReader::depth() const
+{
+  return depth_;
+}
+
+void PrefetchReader::setThreadHooks(const std::function<void()> &begin,
+                                    const std::function<void()> &end)
+{
+  beginHook_ = begin;
+  endHook_ = end;
+}
+
+void PrefetchReader::start()
+{
+  stop();
+
+  // read the debug settings before the reader thread logs anything
+  Debug::dbg(Debug::MEDIUM) << "prefetching " << (int) depth_ << " scans"
+      << Debug::ENDL;
+
+  ring_.reset(new SpscRing<Scan *>(depth_));
+  producerWaits_ = 0;
+  consumerWaits_ = 0;
+  error_ = nullptr;
+  stop_ = false;
+  done_ = false;
+  thread_ = std::thread(&PrefetchReader::run, this);
+}
+
+void PrefetchReader::run()
+{
+  try {
+    if (beginHook_)
+      beginHook_();
+
+    while (!stop_.load(std::memory_order_relaxed)) {
+      Scan *scan = iface_.getScan();
+      if (scan == NULL)
+        break;
+
+      // lazy peaks cannot be read from the caller thread
+      scan->loadPeaks();
+
+      for (int spins = 0; !ring_->push(scan); ++spins) {
+        if (stop_.load(std::memory_order_relaxed)) {
+          delete scan;
+          break;
+        }
+        if (spins == 0)
+          producerWaits_++;
+        backoff(spins);
+      }
+    }
+  }
+  catch (...) {
+    error_ = std::current_exception();
+  }
+
+  try {
+    if (endHook_)
+      endHook_();
+  }
+  catch (...) {
+    if (!error_)
+      error_ = std::current_exception();
+  }
+
+  done_.store(true, std::memory_order_release);
+}
+
+Scan *PrefetchReader::getScan()
+{
+  Scan *scan = NULL;
+  for (int spins = 0; !tryGetScan(scan); ++spins) {
+    if (spins == 0)
+      consumerWaits_++;
+    backoff(spins);
+  }
+
+  return scan;
+}
+
+bool PrefetchReader::tryGetScan(Scan *&scan)
+{
+  scan = NULL;
+  if (!ring_)
+    return true;
+
+  if (ring_->pop(scan))
+    return true;
+
+  if (!done_.load(std::memory_order_acquire))
+    return false;
+
+  // the last scans may have been pushed just before done_
+  if (ring_->pop(scan))
+    return true;
+
+  finish();
+  return true;
+}
+
+void PrefetchReader::finish()
+{
+  if (thread_.joinable())
+    thread_.join();
+
+  if (error_) {
+    std::exception_ptr error = error_;
+    error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+void PrefetchReader::stop()
+{
+  stop_ = true;
+  if (thread_.joinable())
+    thread_.join();
+
+  if (ring_) {
+    Scan *scan = NULL;
+    while (ring_->pop(scan))
+      delete scan;
+  }
+
+  error_ = nullptr;
+}
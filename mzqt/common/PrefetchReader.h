@@ -0,0 +1,127 @@
+/*
+ PrefetchReader.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_PREFETCHREADER_H_
+#define MZQT_PREFETCHREADER_H_
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include "SpscRing.h"
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+namespace mzqt {
+
+  class Scan;
+  class InstrumentInterface;
+
+  /*! Read the scans of an InstrumentInterface in a dedicated thread, ahead
+   * of the caller.
+   *
+   * The reader thread calls InstrumentInterface::getScan() and pushes the
+   * scans into a ring of depth() entries, so that the vendor library works
+   * while the caller processes the previous scans. Typical use:
+   *
+   *   PrefetchReader reader(iface, 32);
+   *   reader.start();
+   *   while ((scan = reader.getScan()) != NULL) {
+   *     ...
+   *     delete scan;
+   *   }
+   *
+   * The interface must not be used by anybody else between start() and
+   * the end of the scans or stop(). Header-only scans get their peaks in
+   * the reader thread before being queued. COM backends need the thread
+   * hooks to initialize COM in the reader thread.
+   */
+  class PrefetchReader {
+
+  public:
+    MZQTDLL_API explicit PrefetchReader(InstrumentInterface &iface,
+        size_t depth = 16);
+    MZQTDLL_API ~PrefetchReader();
+
+    //! \brief number of scans read ahead, taken into account by start()
+    MZQTDLL_API void setDepth(size_t depth);
+    MZQTDLL_API size_t depth() const;
+
+    //! \brief called by the reader thread before its first and after its
+    //! last scan
+    MZQTDLL_API void setThreadHooks(const std::function<void()> &begin,
+        const std::function<void()> &end);
+
+    //! \brief start reading from the current position of the interface
+    MZQTDLL_API void start();
+
+    //! \brief next scan, owned by the caller, NULL after the last one.
+    //! An exception thrown while reading is thrown again here
+    MZQTDLL_API Scan *getScan();
+
+    //! \brief getScan() without waiting: false if the next scan is not
+    //! read yet, true otherwise with scan NULL after the last one
+    MZQTDLL_API bool tryGetScan(Scan *&scan);
+
+    //! \brief stop the reader thread and delete the scans not taken
+    MZQTDLL_API void stop();
+
+    // atomic: the reader thread counts while the caller may read them
+    std::atomic<long> producerWaits_; //!< ring full: the caller is the bottleneck
+    std::atomic<long> consumerWaits_; //!< ring empty: the vendor library is the bottleneck
+
+  private:
+    PrefetchReader(const PrefetchReader &); // intentionally undefined
+    PrefetchReader &operator=(const PrefetchReader &); // intentionally undefined
+
+    void run();
+    void finish();
+
+    InstrumentInterface &iface_;
+    size_t depth_;
+    std::unique_ptr<SpscRing<Scan *> > ring_;
+    std::thread thread_;
+    std::atomic<bool> stop_;
+    std::atomic<bool> done_;
+    std::exception_ptr error_;
+    std::function<void()> beginHook_;
+    std::function<void()> endHook_;
+  };
+
+}
+
+#endif /* MZQT_PREFETCHREADER_H_ */
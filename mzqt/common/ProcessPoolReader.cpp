@@ -0,0 +1,349 @@
+/*
+ ProcessPoolReader.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <atomic>
+#include <memory>
+
+#include <QCoreApplication>
+#include <QProcess>
+
+#include "ProcessPoolReader.h"
+#include "BackendRegistry.h"
+#include "InstrumentInterface.h"
+#include "ShmRing.h"
+#include "SpscRing.h"
+#include "ScanCodec.h"
+#include "Exception.h"
+#include "Scan.h"
+#include "Debug.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+namespace {
+
+  //! deletes the scans still in the list when leaving the scope
+  struct ScanListGuard {
+    std::vector<Scan *> &scans_;
+
+    ~ScanListGuard()
+    {
+      for (size_t i = 0; i < scans_.size(); ++i)
+        delete scans_[i];
+    }
+  };
+
+  //! distinct segment keys for the pools of a process
+  std::atomic<int> numPools(0);
+
+  //! the installed plugins unless registry is given
+  std::unique_ptr<InstrumentInterface> openFile(const QString &fileName,
+                                                const QString &backend,
+                                                BackendRegistry *registry,
+                                                BackendRegistry &plugins)
+  {
+    if (registry == NULL) {
+      plugins.loadPlugins();
+      registry = &plugins;
+    }
+
+    std::unique_ptr<InstrumentInterface> iface(backend.isEmpty()
+        ? registry->createFor(fileName) : registry->create(backend));
+    if (!iface)
+      throw Exception(QString("no backend to read %1").arg(fileName).toStdString());
+
+    iface->initInterface();
+    if (iface->setInputFile(fileName) == false)
+      throw Exception(QString("unable to open %1").arg(fileName).toStdString());
+
+    return iface;
+  }
+
+}
+
+ProcessPoolReader::ProcessPoolReader(const QString &fileName) :
+  waits_(0), fileName_(fileName), registry_(NULL), numWorkers_(4),
+      chunkSize_(64),
+      ringSize_(16 * 1024 * 1024), first_(0), last_(-1), centroid_(false),
+      numChunks_(0), nextChunk_(0)
+{
+  program_ = QCoreApplication::applicationDirPath() + "/mzqtworker";
+}
+
+ProcessPoolReader::~ProcessPoolReader()
+{
+  stop();
+}
+
+void ProcessPoolReader::setNumWorkers(int numWorkers)
+{
+  numWorkers_ = numWorkers;
+}
+
+void ProcessPoolReader::setChunkSize(long numScans)
+{
+  chunkSize_ = numScans > 0 ? numScans : 1;
+}
+
+void ProcessPoolReader::setRingSize(size_t size)
+{
+  ringSize_ = size;
+}
+
+void ProcessPoolReader::setWorkerProgram(const QString &program)
+{
+  program_ = program;
+}
+
+void ProcessPoolReader::setBackend(const QString &name)
+{
+  backend_ = name;
+}
+
+void ProcessPoolReader::setRegistry(BackendRegistry *registry)
+{
+  registry_ = registry;
+}
+
+void ProcessPoolReader::setScanRange(long first, long last)
+{
+  first_ = first;
+  last_ = last;
+}
+
+void ProcessPoolReader::setCentroiding(bool centroid)
+{
+  centroid_ = centroid;
+}
+
+void ProcessPoolReader::readScanRange()
+{
+  BackendRegistry plugins;
+  std::unique_ptr<InstrumentInterface> iface = openFile(fileName_, backend_,
+                                                        registry_, plugins);
+  first_ = iface->firstScanNumber_;
+  last_ = iface->lastScanNumber_;
+}
+
+void ProcessPoolReader::start()
+{
+  stop();
+
+  if (last_ < first_)
+    readScanRange();
+
+  numChunks_ = last_ >= first_ ? (last_ - first_ + chunkSize_) / chunkSize_
+      : 0;
+  nextChunk_ = 0;
+  waits_ = 0;
+
+  int numWorkers = int(qMin(long(qMax(numWorkers_, 1)), numChunks_));
+  int pool = numPools++;
+  Debug::dbg(Debug::MEDIUM) << "reading " << fileName_ << " with "
+      << numWorkers << " workers" << Debug::ENDL;
+
+  for (int i = 0; i < numWorkers; ++i) {
+    Worker worker;
+    worker.ring_ = new ShmRing(QString("mzqt-%1-%2-%3").arg(
+        QCoreApplication::applicationPid()).arg(pool).arg(i));
+    worker.process_ = new QProcess();
+    // deleted by stop() if the start fails
+    workers_.push_back(worker);
+
+    if (worker.ring_->create(ringSize_) == false)
+      throw Exception(QString("unable to create the ring of worker %1: %2").arg(
+          i).arg(worker.ring_->errorString()).toStdString());
+
+    QStringList arguments;
+    arguments << "--file" << fileName_ << "--key" << worker.ring_->key()
+        << "--first" << QString::number(first_ + i * chunkSize_) << "--last"
+        << QString::number(last_) << "--chunk" << QString::number(chunkSize_)
+        << "--stride" << QString::number(numWorkers * chunkSize_);
+    if (!backend_.isEmpty())
+      arguments << "--backend" << backend_;
+    if (centroid_)
+      arguments << "--centroid";
+
+    worker.process_->setProcessChannelMode(QProcess::ForwardedChannels);
+    worker.process_->start(program_, arguments);
+    if (worker.process_->waitForStarted() == false)
+      throw Exception(QString("unable to start %1: %2").arg(program_).arg(
+          worker.process_->errorString()).toStdString());
+  }
+}
+
+QByteArray ProcessPoolReader::nextRecord(size_t worker)
+{
+  ShmRing &ring = *workers_[worker].ring_;
+  QByteArray record;
+
+  for (int spins = 0; !ring.pop(record); ++spins) {
+    if (ring.isClosed()) {
+      // the last records may have been pushed just before the close
+      if (ring.pop(record))
+        break;
+
+      QString error = ring.error();
+      if (error.isEmpty())
+        error = QString("worker %1 ended before its last scan").arg(
+            int(worker));
+      throw Exception(error.toStdString());
+    }
+
+    if (spins == 0)
+      waits_++;
+    else if (spins % 1024 == 0 && workers_[worker].process_->waitForFinished(
+        0) && !ring.isClosed())
+      throw Exception(QString("worker %1 exited with code %2").arg(
+          int(worker)).arg(workers_[worker].process_->exitCode()).toStdString());
+    backoff(spins);
+  }
+
+  return record;
+}
+
+Scan *ProcessPoolReader::getScan()
+{
+  while (nextChunk_ < numChunks_) {
+    QByteArray record = nextRecord(size_t(nextChunk_ % workers_.size()));
+
+    // an empty record ends a chunk
+    if (record.isEmpty()) {
+      nextChunk_++;
+      continue;
+    }
+
+    return ScanCodec::decode(record);
+  }
+
+  return NULL;
+}
+
+void ProcessPoolReader::stop()
+{
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    Worker &worker = workers_[i];
+    if (worker.ring_->isAttached())
+      worker.ring_->cancel();
+
+    if (worker.process_->state() != QProcess::NotRunning
+        && worker.process_->waitForFinished(3000) == false) {
+      worker.process_->kill();
+      worker.process_->waitForFinished();
+    }
+
+    delete worker.process_;
+    delete worker.ring_;
+  }
+
+  workers_.clear();
+  numChunks_ = 0;
+  nextChunk_ = 0;
+}
+
+int ProcessPoolReader::workerMain(const QStringList &arguments,
+                                  BackendRegistry *registry)
+{
+  QString fileName, key, backend;
+  long first = 0, last = -1, chunkSize = 1, stride = 1;
+  bool centroid = false;
+
+  for (int i = 1; i < arguments.size(); ++i) {
+    const QString &argument = arguments[i];
+    QString value = i + 1 < arguments.size() ? arguments[i + 1] : QString();
+    if (argument == "--centroid") {
+      centroid = true;
+      continue;
+    }
+
+    if (argument == "--file")
+      fileName = value;
+    else if (argument == "--key")
+      key = value;
+    else if (argument == "--backend")
+      backend = value;
+    else if (argument == "--first")
+      first = value.toLong();
+    else if (argument == "--last")
+      last = value.toLong();
+    else if (argument == "--chunk")
+      chunkSize = qMax(value.toLong(), 1L);
+    else if (argument == "--stride")
+      stride = value.toLong();
+    else {
+      Debug::msg() << "unknown worker argument " << argument;
+      return 2;
+    }
+    ++i;
+  }
+
+  ShmRing ring(key);
+  if (ring.attach() == false) {
+    Debug::msg() << "unable to attach to " << key << ": "
+        << ring.errorString();
+    return 2;
+  }
+
+  try {
+    BackendRegistry plugins;
+    std::unique_ptr<InstrumentInterface> iface = openFile(fileName, backend,
+                                                          registry, plugins);
+    iface->setCentroiding(centroid);
+
+    std::vector<Scan *> scans;
+    ScanListGuard guard = { scans };
+    for (long chunk = first; chunk <= last; chunk += stride) {
+      scans.clear();
+      iface->getScans(chunk, qMin(chunk + chunkSize - 1, last), scans);
+
+      for (size_t i = 0; i < scans.size(); ++i) {
+        std::unique_ptr<Scan> scan(scans[i]);
+        scans[i] = NULL;
+        QByteArray record = ScanCodec::encode(*scan);
+        if (size_t(record.size()) > ring.maxRecordSize())
+          throw Exception(QString("scan %1 does not fit in the ring").arg(
+              scan->scanNumber_).toStdString());
+
+        for (int spins = 0; !ring.push(record); ++spins) {
+          if (ring.isCancelled())
+            return 0;
+          backoff(spins);
+        }
+      }
+
+      for (int spins = 0; !ring.push(QByteArray()); ++spins) {
+        if (ring.isCancelled())
+          return 0;
+        backoff(spins);
+      }
+    }
+  }
+  catch (std::exception &e) {
+    ring.close(e.what());
+    return 1;
+  }
+
+  ring.close();
+  return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ ProcessPoolReader.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_PROCESSPOOLREADER_H_
+#define MZQT_PROCESSPOOLREADER_H_
+
+#include <vector>
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+class QProcess;
+
+namespace mzqt {
+
+  class BackendRegistry;
+  class Scan;
+  class ShmRing;
+
+  /*! Read one run with several worker processes, for the vendor components
+   * which serve one caller at a time per process.
+   *
+   * The scan range is cut in chunks of chunkSize scans given round robin to
+   * the workers: worker k reads chunks k, k + n, k + 2n... of the run it
+   * opens itself and sends the scans back through its own ShmRing. The
+   * chunks are read back in order, so getScan() returns the scans in scan
+   * number order as the interface would. Typical use:
+   *
+   *   ProcessPoolReader reader(fileName);
+   *   reader.setNumWorkers(4);
+   *   reader.start();
+   *   while ((scan = reader.getScan()) != NULL) {
+   *     ...
+   *     delete scan;
+   *   }
+   *
+   * The workers are the mzqtworker program next to the application, or any
+   * program calling workerMain() with its arguments. The scan range is read
+   * from the file in this process unless given.
+   */
+  class ProcessPoolReader {
+
+  public:
+    MZQTDLL_API explicit ProcessPoolReader(const QString &fileName);
+    //! \brief the workers are stopped
+    MZQTDLL_API ~ProcessPoolReader();
+
+    MZQTDLL_API void setNumWorkers(int numWorkers);
+    MZQTDLL_API void setChunkSize(long numScans);
+    //! \brief bytes of scans buffered per worker
+    MZQTDLL_API void setRingSize(size_t size);
+    MZQTDLL_API void setWorkerProgram(const QString &program);
+    //! \brief BackendRegistry name, by default the first backend which can
+    //! read the file
+    MZQTDLL_API void setBackend(const QString &name);
+    //! \brief backends opening the file in this process, not owned. By
+    //! default, the installed plugins. The workers have their own
+    MZQTDLL_API void setRegistry(BackendRegistry *registry);
+    //! \brief by default, all the scans of the file
+    MZQTDLL_API void setScanRange(long first, long last);
+    MZQTDLL_API void setCentroiding(bool centroid);
+
+    //! \brief start the workers, throws Exception if one cannot be started
+    MZQTDLL_API void start();
+
+    //! \brief next scan, owned by the caller, NULL after the last one.
+    //! Throws Exception if a worker failed
+    MZQTDLL_API Scan *getScan();
+
+    //! \brief stop the workers and drop the scans not taken
+    MZQTDLL_API void stop();
+
+    long waits_; //!< the next scan was not read yet: the workers are the bottleneck
+
+    //! \brief body of a worker process, returns its exit code. The file is
+    //! opened with registry, by default the installed plugins
+    MZQTDLL_API static int workerMain(const QStringList &arguments,
+                                      BackendRegistry *registry = NULL);
+
+  private:
+    ProcessPoolReader(const ProcessPoolReader &); // intentionally undefined
+    ProcessPoolReader &operator=(const ProcessPoolReader &); // intentionally undefined
+
+    struct Worker {
+      QProcess *process_;
+      ShmRing *ring_;
+    };
+
+    void readScanRange();
+    QByteArray nextRecord(size_t worker);
+
+    QString fileName_;
+    QString program_;
+    QString backend_;
+    BackendRegistry *registry_;
+    int numWorkers_;
+    long chunkSize_;
+    size_t ringSize_;
+    long first_;
+    long last_;
+    bool centroid_;
+
+    std::vector<Worker> workers_;
+    long numChunks_;
+    long nextChunk_;
+  };
+
+}
+
+#endif /* MZQT_PROCESSPOOLREADER_H_ */
@@ -0,0 +1,108 @@
+/*
+ Progress.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <climits>
+
+#include "Progress.h"
+#include "Exception.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+void CancellationToken::check() const
+{
+  if (isCancelled())
+    throw Abort("cancelled");
+}
+
+ProgressReporter::ProgressReporter() :
+  intervalScans_(1000), intervalMs_(250), token_(NULL),
+      stage_(PROGRESS_READING), total_(-1), done_(0), nextReport_(1000),
+      bytes_(0), finished_(true)
+{
+  startTime_ = lastReportTime_ = Clock::now();
+}
+
+void ProgressReporter::setCallback(const Callback &callback)
+{
+  callback_ = callback;
+}
+
+void ProgressReporter::setInterval(long numScans, long ms)
+{
+  intervalScans_ = numScans;
+  intervalMs_ = ms;
+  nextReport_ = intervalScans_ > 0 ? done_ + intervalScans_ : LONG_MAX;
+}
+
+void ProgressReporter::setCancellationToken(const CancellationToken *token)
+{
+  token_ = token;
+}
+
+void ProgressReporter::start(ProgressStage stage, long total)
+{
+  stage_ = stage;
+  total_ = total;
+  done_ = 0;
+  nextReport_ = intervalScans_ > 0 ? intervalScans_ : LONG_MAX;
+  bytes_.store(0, std::memory_order_relaxed);
+  startTime_ = lastReportTime_ = Clock::now();
+  finished_ = false;
+}
+
+void ProgressReporter::finish()
+{
+  if (finished_)
+    return;
+
+  report();
+  finished_ = true;
+}
+
+void ProgressReporter::report()
+{
+  Clock::time_point now = Clock::now();
+  lastReportTime_ = now;
+  nextReport_ = intervalScans_ > 0 ? done_ + intervalScans_ : LONG_MAX;
+
+  if (!callback_)
+    return;
+
+  ProgressInfo info;
+  info.stage_ = stage_;
+  info.done_ = done_;
+  info.total_ = total_;
+  info.elapsedInSec_
+      = std::chrono::duration<double>(now - startTime_).count();
+  info.scansPerSec_ = 0;
+  info.megaBytesPerSec_ = 0;
+  if (info.elapsedInSec_ > 0) {
+    info.scansPerSec_ = done_ / info.elapsedInSec_;
+    info.megaBytesPerSec_ = bytes_.load(std::memory_order_relaxed)
+        / (1024.0 * 1024.0) / info.elapsedInSec_;
+  }
+
+  callback_(info);
+}
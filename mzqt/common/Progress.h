@@ -0,0 +1,172 @@
+/*
+ Progress.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_PROGRESS_H_
+#define MZQT_PROGRESS_H_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+#include <QtGlobal>
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+namespace mzqt {
+
+  enum ProgressStage {
+    PROGRESS_PREPROCESSING, PROGRESS_READING
+  };
+
+  struct ProgressInfo {
+    ProgressStage stage_;
+    long done_; // scans looked at since the start of the stage
+    long total_; // -1 if unknown
+    double elapsedInSec_;
+    double scansPerSec_;
+    double megaBytesPerSec_; // peak data read, 0 while preprocessing
+  };
+
+  /*! Flag shared between the thread that wants to stop a conversion and the
+   * reading thread, which checks it between two scans.
+   */
+  class CancellationToken {
+
+  public:
+    CancellationToken() :
+      cancelled_(false)
+    {
+    }
+
+    //! \brief may be called from any thread
+    void cancel()
+    {
+      cancelled_.store(true, std::memory_order_relaxed);
+    }
+
+    void reset()
+    {
+      cancelled_.store(false, std::memory_order_relaxed);
+    }
+
+    bool isCancelled() const
+    {
+      return cancelled_.load(std::memory_order_relaxed);
+    }
+
+    //! \brief throw Abort if cancelled
+    MZQTDLL_API void check() const;
+
+  private:
+    std::atomic<bool> cancelled_;
+  };
+
+  /*! Throttled progress of the preprocessing and reading loops of an
+   * InstrumentInterface.
+   *
+   * advance() is called once per scan: it checks the cancellation token
+   * and gives a ProgressInfo to the callback every numScans scans or every
+   * ms milliseconds, whichever comes first, instead of once per scan.
+   */
+  class ProgressReporter {
+
+  public:
+    typedef std::function<void(const ProgressInfo &)> Callback;
+
+    MZQTDLL_API ProgressReporter();
+
+    MZQTDLL_API void setCallback(const Callback &callback);
+    //! \brief 0 disables the corresponding criterion
+    MZQTDLL_API void setInterval(long numScans, long ms);
+    //! \brief token checked by advance(), not owned. NULL to stop checking
+    MZQTDLL_API void setCancellationToken(const CancellationToken *token);
+
+    MZQTDLL_API void start(ProgressStage stage, long total);
+    //! \brief count numScans scans, report if due. Returns true if a report
+    //! was due, throws Abort if cancelled
+    inline bool advance(long numScans = 1);
+    //! \brief count bytes of peak data read. Header-only scans may have
+    //! their peaks read by another thread
+    void addBytes(qint64 numBytes)
+    {
+      bytes_.fetch_add(numBytes, std::memory_order_relaxed);
+    }
+    //! \brief final report of the stage, if not done already
+    MZQTDLL_API void finish();
+
+    //! \brief throw Abort if cancelled
+    void checkCancelled() const
+    {
+      if (token_ != NULL)
+        token_->check();
+    }
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    MZQTDLL_API void report(); // called by the inline advance()
+
+    Callback callback_;
+    long intervalScans_;
+    long intervalMs_;
+    const CancellationToken *token_;
+
+    ProgressStage stage_;
+    long total_;
+    long done_;
+    long nextReport_; // value of done_ that triggers the next report
+    std::atomic<qint64> bytes_;
+    Clock::time_point startTime_;
+    Clock::time_point lastReportTime_;
+    bool finished_;
+  };
+
+  bool ProgressReporter::advance(long numScans)
+  {
+    checkCancelled();
+
+    done_ += numScans;
+    if (done_ >= nextReport_ || (intervalMs_ > 0 && Clock::now()
+        - lastReportTime_ >= std::chrono::milliseconds(intervalMs_))) {
+      report();
+      return true;
+    }
+
+    return false;
+  }
+
+}
+
+#endif /* MZQT_PROGRESS_H_ */
@@ -53,6 +53,7 @@ typedef struct _peak {
 
 int Scan::getNumDataPoints(void) const
 {
+    loadPeaks();
     return numDataPoints_;
 }
 
@@ -61,6 +62,8 @@ void Scan::setNumDataPoints(int numDataPoints)
     Debug::dbg(Debug::MEDIUM) << "setting datapoints: " << numDataPoints
                             << Debug::ENDL;
 
+    peakLoader_ = nullptr;
+
     if (numDataPoints == 0) {
         numDataPoints_ = numDataPoints;
         return;
@@ -87,20 +90,44 @@ const double* Scan::getIntensityArray() const
 #else
 void Scan::getMZArray(double **a) const
 {
+  loadPeaks();
   *a = mzArray_;
 }
 
 void Scan::getIntensityArray(double **a) const
 {
+  loadPeaks();
   *a = intensityArray_;
 }
 #endif
 
 void Scan::resetNumDataPoints(int numDataPoints)
 {
+    peakLoader_ = nullptr;
     numDataPoints_ = numDataPoints;
 }
 
+void Scan::setPeakLoader(const std::function<void(Scan &)> &loader)
+{
+    peakLoader_ = loader;
+}
+
+bool Scan::hasPendingPeaks(void) const
+{
+    return static_cast<bool>(peakLoader_);
+}
+
+void Scan::loadPeaks(void) const
+{
+    if (!peakLoader_)
+        return;
+
+    // the loader sets the peaks: take it out first
+    std::function<void(Scan &)> loader;
+    loader.swap(peakLoader_);
+    loader(const_cast<Scan &>(*this));
+}
+
 void Scan::setNumScanOrigins(int numScanOrigins)
 {
     numScanOrigins_ = numScanOrigins;
@@ -112,6 +139,7 @@ Scan::Scan()
 {
     numDataPoints_ = 0;
 
+    scanNumber_ = -1;
     msLevel_ = 0;
     charge_ = -1;
     startMZ_ = -1;
@@ -135,6 +163,7 @@ Scan::Scan()
     precursorMZ_ = -1;
     accuratePrecursorMZ_ = false;
     precursorIntensity_ = -1;
+    precursorPurity_ = -1;
     collisionEnergy_ = -1;
 
     // thermo scans only:
@@ -155,6 +184,12 @@ Scan::Scan()
     isThresholded_ = false;
     threshold_ = -1;
 
+    contentHash_ = 0;
+    isDuplicate_ = false;
+    isDegenerate_ = false;
+
+    runIndex_ = -1;
+
     // initialize to NULL so that delete can be called alway
     mzArray_ = NULL;
     intensityArray_ = NULL;
@@ -164,6 +199,12 @@ Scan::Scan()
 
 Scan::Scan(const Scan& copy)
 {
+    // setNumDataPoints() deletes the previous arrays
+    numDataPoints_ = 0;
+    mzArray_ = NULL;
+    intensityArray_ = NULL;
+
+    scanNumber_ = copy.scanNumber_;
     msLevel_ = copy.msLevel_;
     charge_ = copy.charge_;
     startMZ_ = copy.startMZ_;
@@ -186,6 +227,7 @@ Scan::Scan(const Scan& copy)
     precursorMZ_ = copy.precursorMZ_;
     accuratePrecursorMZ_ = copy.accuratePrecursorMZ_;
     precursorIntensity_ = copy.precursorIntensity_;
+    precursorPurity_ = copy.precursorPurity_;
     collisionEnergy_ = copy.collisionEnergy_;
     isThermo_ = copy.isThermo_;
     segment_ = copy.segment_;
@@ -194,14 +236,23 @@ Scan::Scan(const Scan& copy)
     dependentActive_ = copy.dependentActive_;
     sourceCIDOn_ = copy.sourceCIDOn_;
     cidParentMass_ = copy.cidParentMass_;
+    cidEnergy_ = copy.cidEnergy_;
+    msx_ = copy.msx_;
+    isolationWindow_ = copy.isolationWindow_;
     isMassLynx_ = copy.isMassLynx_;
     isCalibrated_ = copy.isCalibrated_;
     isMerged_ = copy.isMerged_;
     mergedScanNum_ = copy.mergedScanNum_;
     isThresholded_ = copy.isThresholded_;
     threshold_ = copy.threshold_;
+    contentHash_ = copy.contentHash_;
+    isDuplicate_ = copy.isDuplicate_;
+    isDegenerate_ = copy.isDegenerate_;
+    runIndex_ = copy.runIndex_;
 
     numScanOrigins_ = copy.numScanOrigins_;
+    scanOriginNums = copy.scanOriginNums;
+    scanOriginParentFileIDs = copy.scanOriginParentFileIDs;
 
     setNumDataPoints(copy.getNumDataPoints());
     for (int i = 0; i < numDataPoints_; i++) {
@@ -229,6 +280,7 @@ Scan::~Scan()
 
 void Scan::centroid(string instrument)
 {
+    loadPeaks();
 
     // presumed resolution - should be conservative?
     double res400 = 10000.0; // for TOF
@@ -490,6 +542,7 @@ void Scan::centroid(string instrument)
 // if not discard, rewrite as zero
 void Scan::threshold(double inclusiveCutoff, bool discard)
 {
+    loadPeaks();
 
     vector<Peak> newPeakList;
     newPeakList.clear();
@@ -30,6 +30,7 @@
 
 
 #include <vector>
+#include <functional>
 #include <QString>
 
 #include "MSTypes.h"
@@ -96,7 +97,8 @@ namespace mzqt {
         }
 
     public:
-        NativeScanRef()
+        NativeScanRef() :
+            coordinateType_(MANUFACTURER_UNDEF)
         {
         }
         NativeScanRef(MSManufacturerType coordinateType)
@@ -110,6 +112,7 @@ namespace mzqt {
 
     class Scan {
     public:
+        long scanNumber_; // native scan number in the source file, -1 if unknown
         int msLevel_;
         int charge_;
 
@@ -142,6 +145,7 @@ namespace mzqt {
         double precursorMZ_;
         bool accuratePrecursorMZ_;
         double precursorIntensity_;
+        double precursorPurity_; // fraction of the isolation window intensity in the precursor isotopes, -1 if unknown
         double collisionEnergy_; // for MSn, this refers to the collision which produced the nth level fragment
 
         // for thermo scans only
@@ -169,11 +173,21 @@ namespace mzqt {
         bool isThresholded_;
         double threshold_;
 
+        // content of the peak arrays, see ScanHasher
+        quint64 contentHash_; // 0 if not computed
+        bool isDuplicate_; // same peaks as a previous scan
+        bool isDegenerate_; // all intensities zero or equal
+
+        int runIndex_; // source run in a Dataset, -1 if read directly
+
         NativeScanRef nativeScanRef_;
 
     protected:
         int numDataPoints_;
 
+        // reads the peaks of a header-only scan on first access
+        mutable std::function<void(Scan &)> peakLoader_;
+
     public:
         MZQTDLL_API void getMZArray(double **a) const;
         MZQTDLL_API void getIntensityArray(double **a) const;
@@ -182,6 +196,14 @@ namespace mzqt {
         MZQTDLL_API void setNumDataPoints(int numDataPoints); // (re)allocates arrays
         MZQTDLL_API void resetNumDataPoints(int numDataPoints); // set actual number of data points
 
+        // lazy peaks: the loader is called by the first of getNumDataPoints(),
+        // getMZArray(), getIntensityArray() or loadPeaks(). The arrays must not
+        // be read directly before. Setting the number of data points cancels
+        // the loading
+        MZQTDLL_API void setPeakLoader(const std::function<void(Scan &)> &loader);
+        MZQTDLL_API bool hasPendingPeaks(void) const;
+        MZQTDLL_API void loadPeaks(void) const;
+
         double* mzArray_;
         double* intensityArray_;
 
@@ -0,0 +1,233 @@
+/*
+ ScanCodec.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <memory>
+
+#include <QDataStream>
+
+#include "ScanCodec.h"
+#include "Scan.h"
+#include "Exception.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+namespace {
+
+  //! changed whenever a field is added to the encoding
+  const quint32 CODEC_VERSION = 1;
+
+  void writeDoubles(QDataStream &stream, const std::vector<double> &values)
+  {
+    stream << quint32(values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+      stream << values[i];
+  }
+
+  void readDoubles(QDataStream &stream, std::vector<double> &values)
+  {
+    quint32 size;
+    stream >> size;
+    values.resize(stream.status() == QDataStream::Ok ? size : 0);
+    for (size_t i = 0; i < values.size(); ++i)
+      stream >> values[i];
+  }
+
+  template<class T> void readEnum(QDataStream &stream, T &value)
+  {
+    qint32 v;
+    stream >> v;
+    value = T(v);
+  }
+
+}
+
+QByteArray ScanCodec::encode(const Scan &scan)
+{
+  // before numDataPoints_ is read
+  scan.loadPeaks();
+
+  QByteArray data;
+  QDataStream stream(&data, QIODevice::WriteOnly);
+  stream.setByteOrder(QDataStream::LittleEndian);
+
+  stream << CODEC_VERSION;
+  stream << qint64(scan.scanNumber_) << qint32(scan.msLevel_)
+      << qint32(scan.charge_);
+  stream << scan.startMZ_ << scan.endMZ_ << scan.minObservedMZ_
+      << scan.maxObservedMZ_ << scan.basePeakMZ_ << scan.basePeakIntensity_
+      << scan.totalIonCurrent_ << scan.retentionTimeInSec_;
+  stream << qint32(scan.polarity_) << qint32(scan.analyzer_)
+      << qint32(scan.ionization_) << qint32(scan.scanType_)
+      << qint32(scan.activation_);
+  stream << scan.isCentroided_;
+
+  stream << qint64(scan.precursorScanNumber_)
+      << qint32(scan.precursorScanMSLevel_) << qint32(scan.precursorCharge_)
+      << scan.precursorMZ_ << scan.accuratePrecursorMZ_
+      << scan.precursorIntensity_ << scan.precursorPurity_
+      << scan.collisionEnergy_;
+
+  stream << scan.isThermo_ << qint32(scan.segment_) << qint32(scan.event_)
+      << scan.thermoFilterLine_ << scan.dependentActive_
+      << scan.sourceCIDOn_;
+  writeDoubles(stream, scan.cidParentMass_);
+  writeDoubles(stream, scan.cidEnergy_);
+  stream << scan.msx_ << scan.isolationWindow_;
+
+  stream << scan.isMassLynx_ << scan.isCalibrated_ << scan.isMerged_
+      << qint64(scan.mergedScanNum_) << scan.isThresholded_
+      << scan.threshold_;
+  stream << scan.contentHash_ << scan.isDuplicate_ << scan.isDegenerate_
+      << qint32(scan.runIndex_);
+
+  const NativeScanRef &ref = scan.nativeScanRef_;
+  stream << qint32(ref.coordinateType_) << quint32(ref.coordinates_.size());
+  for (size_t i = 0; i < ref.coordinates_.size(); ++i)
+    stream << qint32(ref.coordinates_[i].first) << QByteArray(
+        ref.coordinates_[i].second.c_str(),
+        int(ref.coordinates_[i].second.size()));
+
+  stream << quint32(scan.scanOriginNums.size());
+  for (size_t i = 0; i < scan.scanOriginNums.size(); ++i)
+    stream << qint64(scan.scanOriginNums[i]);
+  stream << quint32(scan.scanOriginParentFileIDs.size());
+  for (size_t i = 0; i < scan.scanOriginParentFileIDs.size(); ++i)
+    stream << scan.scanOriginParentFileIDs[i];
+
+  int numDataPoints = scan.getNumDataPoints();
+  stream << qint32(numDataPoints);
+  if (numDataPoints > 0) {
+    double *mz, *intensity;
+    scan.getMZArray(&mz);
+    scan.getIntensityArray(&intensity);
+    stream.writeRawData(reinterpret_cast<const char *> (mz), numDataPoints
+        * int(sizeof(double)));
+    stream.writeRawData(reinterpret_cast<const char *> (intensity),
+                        numDataPoints * int(sizeof(double)));
+  }
+
+  return data;
+}
+
+Scan *ScanCodec::decode(const QByteArray &data)
+{
+  QDataStream stream(data);
+  stream.setByteOrder(QDataStream::LittleEndian);
+
+  quint32 version;
+  stream >> version;
+  if (stream.status() != QDataStream::Ok || version != CODEC_VERSION)
+    throw Exception("unknown encoded scan version");
+
+  std::unique_ptr<Scan> scan(new Scan());
+  qint64 i64;
+  qint32 i32;
+
+  stream >> i64;
+  scan->scanNumber_ = long(i64);
+  stream >> i32;
+  scan->msLevel_ = i32;
+  stream >> i32;
+  scan->charge_ = i32;
+  stream >> scan->startMZ_ >> scan->endMZ_ >> scan->minObservedMZ_
+      >> scan->maxObservedMZ_ >> scan->basePeakMZ_
+      >> scan->basePeakIntensity_ >> scan->totalIonCurrent_
+      >> scan->retentionTimeInSec_;
+  readEnum(stream, scan->polarity_);
+  readEnum(stream, scan->analyzer_);
+  readEnum(stream, scan->ionization_);
+  readEnum(stream, scan->scanType_);
+  readEnum(stream, scan->activation_);
+  stream >> scan->isCentroided_;
+
+  stream >> i64;
+  scan->precursorScanNumber_ = long(i64);
+  stream >> i32;
+  scan->precursorScanMSLevel_ = i32;
+  stream >> i32;
+  scan->precursorCharge_ = i32;
+  stream >> scan->precursorMZ_ >> scan->accuratePrecursorMZ_
+      >> scan->precursorIntensity_ >> scan->precursorPurity_
+      >> scan->collisionEnergy_;
+
+  stream >> scan->isThermo_;
+  stream >> i32;
+  scan->segment_ = i32;
+  stream >> i32;
+  scan->event_ = i32;
+  stream >> scan->thermoFilterLine_ >> scan->dependentActive_
+      >> scan->sourceCIDOn_;
+  readDoubles(stream, scan->cidParentMass_);
+  readDoubles(stream, scan->cidEnergy_);
+  stream >> scan->msx_ >> scan->isolationWindow_;
+
+  stream >> scan->isMassLynx_ >> scan->isCalibrated_ >> scan->isMerged_;
+  stream >> i64;
+  scan->mergedScanNum_ = long(i64);
+  stream >> scan->isThresholded_ >> scan->threshold_;
+  stream >> scan->contentHash_ >> scan->isDuplicate_ >> scan->isDegenerate_;
+  stream >> i32;
+  scan->runIndex_ = i32;
+
+  NativeScanRef &ref = scan->nativeScanRef_;
+  readEnum(stream, ref.coordinateType_);
+  quint32 size;
+  stream >> size;
+  for (quint32 i = 0; i < size && stream.status() == QDataStream::Ok; ++i) {
+    ScanCoordinateType name;
+    QByteArray value;
+    readEnum(stream, name);
+    stream >> value;
+    ref.addCoordinate(name, std::string(value.constData(), value.size()));
+  }
+
+  stream >> size;
+  for (quint32 i = 0; i < size && stream.status() == QDataStream::Ok; ++i) {
+    stream >> i64;
+    scan->scanOriginNums.push_back(long(i64));
+  }
+  stream >> size;
+  for (quint32 i = 0; i < size && stream.status() == QDataStream::Ok; ++i) {
+    QString id;
+    stream >> id;
+    scan->scanOriginParentFileIDs.push_back(id);
+  }
+  scan->setNumScanOrigins(int(scan->scanOriginNums.size()));
+
+  stream >> i32;
+  if (stream.status() != QDataStream::Ok || i32 < 0)
+    throw Exception("truncated encoded scan");
+
+  scan->setNumDataPoints(i32);
+  if (i32 > 0) {
+    int bytes = i32 * int(sizeof(double));
+    if (stream.readRawData(reinterpret_cast<char *> (scan->mzArray_), bytes)
+        != bytes || stream.readRawData(
+        reinterpret_cast<char *> (scan->intensityArray_), bytes) != bytes)
+      throw Exception("truncated encoded scan");
+  }
+
+  return scan.release();
+}
@@ -0,0 +1,63 @@
+/*
+ ScanCodec.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_SCANCODEC_H_
+#define MZQT_SCANCODEC_H_
+
+#include <QByteArray>
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+namespace mzqt {
+
+  class Scan;
+
+  /*! Binary form of a Scan, header and peaks, to move scans between
+   * processes of the same build. The peak arrays are copied in the byte
+   * order of the machine: the data is not meant to be stored.
+   */
+  class ScanCodec {
+
+  public:
+    //! \brief header-only scans get their peaks before being encoded
+    MZQTDLL_API static QByteArray encode(const Scan &scan);
+    //! \brief new scan owned by the caller, throws Exception if data is not
+    //! a scan encoded by the same version of the codec
+    MZQTDLL_API static Scan *decode(const QByteArray &data);
+  };
+
+}
+
+#endif /* MZQT_SCANCODEC_H_ */
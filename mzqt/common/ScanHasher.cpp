@@ -0,0 +1,207 @@
+/*
+ ScanHasher.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <algorithm>
+#include <cstring>
+
+#include "ScanHasher.h"
+#include "Scan.h"
+#include "Debug.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+namespace {
+
+  const quint64 PRIME1 = Q_UINT64_C(0x9E3779B185EBCA87);
+  const quint64 PRIME2 = Q_UINT64_C(0xC2B2AE3D27D4EB4F);
+  const quint64 PRIME3 = Q_UINT64_C(0x165667B19E3779F9);
+
+  inline quint64 bits(double value)
+  {
+    quint64 result;
+    std::memcpy(&result, &value, sizeof(result));
+    return result;
+  }
+
+  inline quint64 rotate(quint64 value, int shift)
+  {
+    return (value << shift) | (value >> (64 - shift));
+  }
+
+  inline quint64 round(quint64 lane, quint64 value)
+  {
+    return rotate(lane + value * PRIME2, 31) * PRIME1;
+  }
+
+  inline quint64 avalanche(quint64 h)
+  {
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+  }
+
+  //! hash of the peaks, also telling if all the intensities are equal
+  quint64 hashPeaks(const double *mz, const double *intensity, int size,
+                    bool &constant)
+  {
+    // four independent lanes: no dependency between consecutive peaks, the
+    // loop can be vectorized
+    quint64 lane0 = PRIME1 + PRIME2, lane1 = PRIME2, lane2 = 0, lane3 = PRIME3;
+    double first = size > 0 ? intensity[0] : 0;
+    int different = 0;
+
+    int i = 0;
+    for (; i + 4 <= size; i += 4) {
+      lane0 = round(lane0, bits(mz[i]) ^ rotate(bits(intensity[i]), 17));
+      lane1 = round(lane1, bits(mz[i + 1]) ^ rotate(bits(intensity[i + 1]), 17));
+      lane2 = round(lane2, bits(mz[i + 2]) ^ rotate(bits(intensity[i + 2]), 17));
+      lane3 = round(lane3, bits(mz[i + 3]) ^ rotate(bits(intensity[i + 3]), 17));
+      different |= (intensity[i] != first) | (intensity[i + 1] != first)
+          | (intensity[i + 2] != first) | (intensity[i + 3] != first);
+    }
+
+    quint64 h = rotate(lane0, 1) + rotate(lane1, 7) + rotate(lane2, 12)
+        + rotate(lane3, 18);
+    for (; i < size; ++i) {
+      h = round(h, bits(mz[i]) ^ rotate(bits(intensity[i]), 17));
+      different |= intensity[i] != first;
+    }
+    h ^= (quint64) size * PRIME3;
+
+    constant = different == 0;
+
+    return avalanche(h);
+  }
+
+}
+
+ScanHasher::ScanHasher() :
+  duplicateScans_(0), degenerateScans_(0), dropDuplicates_(false),
+      dropDegenerate_(false), comparedScans_(16)
+{
+}
+
+void ScanHasher::setDropDuplicates(bool drop)
+{
+  dropDuplicates_ = drop;
+}
+
+void ScanHasher::setDropDegenerate(bool drop)
+{
+  dropDegenerate_ = drop;
+}
+
+void ScanHasher::setComparedScans(int numScans)
+{
+  comparedScans_ = std::max(numScans, 0);
+  while (keptHashes_.size() > comparedScans_) {
+    peaks_.remove(keptHashes_.front());
+    keptHashes_.pop_front();
+  }
+}
+
+void ScanHasher::clear()
+{
+  seen_.clear();
+  peaks_.clear();
+  keptHashes_.clear();
+  duplicateScans_ = 0;
+  degenerateScans_ = 0;
+}
+
+quint64 ScanHasher::hash(const double *mz, const double *intensity, int size)
+{
+  bool constant;
+  return hashPeaks(mz, intensity, size, constant);
+}
+
+bool ScanHasher::check(Scan &scan)
+{
+  int size = scan.getNumDataPoints();
+
+  // empty scans are legitimate and all look the same
+  if (size == 0)
+    return true;
+
+  bool constant, compared = false;
+  scan.contentHash_ = hashPeaks(scan.mzArray_, scan.intensityArray_, size,
+                                constant);
+
+  // a single peak is not degenerate, one with no intensity is
+  scan.isDegenerate_ = constant && (size > 1 || scan.intensityArray_[0] <= 0);
+  if (scan.isDegenerate_) {
+    degenerateScans_++;
+    Debug::dbg(Debug::HIGH) << "degenerate scan: " << scan.scanNumber_
+        << Debug::ENDL;
+  }
+  else if (seen_.contains(scan.contentHash_)) {
+    QHash<quint64, Peaks>::const_iterator kept = peaks_.constFind(
+        scan.contentHash_);
+    compared = kept != peaks_.constEnd();
+    // a collision of the hash is not a duplicate
+    if (!compared || (kept.value().mz_.size() == (size_t) size
+        && std::equal(kept.value().mz_.begin(), kept.value().mz_.end(),
+                      scan.mzArray_)
+        && std::equal(kept.value().intensity_.begin(),
+                      kept.value().intensity_.end(), scan.intensityArray_))) {
+      scan.isDuplicate_ = true;
+      duplicateScans_++;
+      Debug::dbg(Debug::HIGH) << "duplicate scan: " << scan.scanNumber_
+          << Debug::ENDL;
+    }
+  }
+  else {
+    seen_.insert(scan.contentHash_);
+    if (dropDuplicates_)
+      keepPeaks(scan.contentHash_, scan);
+  }
+
+  if ((scan.isDegenerate_ && dropDegenerate_) || (scan.isDuplicate_
+      && dropDuplicates_ && compared)) {
+    scan.setNumDataPoints(0);
+    return false;
+  }
+
+  return true;
+}
+
+void ScanHasher::keepPeaks(quint64 hash, const Scan &scan)
+{
+  if (comparedScans_ == 0)
+    return;
+  if (keptHashes_.size() == comparedScans_) {
+    peaks_.remove(keptHashes_.front());
+    keptHashes_.pop_front();
+  }
+
+  int size = scan.getNumDataPoints();
+  Peaks &peaks = peaks_[hash];
+  peaks.mz_.assign(scan.mzArray_, scan.mzArray_ + size);
+  peaks.intensity_.assign(scan.intensityArray_, scan.intensityArray_ + size);
+  keptHashes_.push_back(hash);
+}
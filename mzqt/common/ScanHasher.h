@@ -0,0 +1,109 @@
+/*
+ ScanHasher.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_SCANHASHER_H_
+#define MZQT_SCANHASHER_H_
+
+#include <deque>
+#include <vector>
+
+#include <QHash>
+#include <QSet>
+#include <QtGlobal>
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+namespace mzqt {
+
+  class Scan;
+
+  /*! Hash the content of scans to find repeated spectra and spectra that
+   * carry no information (all intensities zero or equal), like the
+   * uninitialized scans written by some Waters instruments.
+   *
+   * The hash and the degenerate test are computed in the same pass over the
+   * peak arrays. The hash is not cryptographic: the peaks of a duplicate
+   * are only dropped once compared with those of the scan it repeats. These
+   * are kept for the last few distinct scans when dropping, as the repeated
+   * spectra of the instruments follow each other; an older duplicate is
+   * flagged by its hash, not dropped.
+   */
+  class ScanHasher {
+
+  public:
+    MZQTDLL_API ScanHasher();
+
+    //! \brief empty the peaks of duplicate scans instead of flagging them
+    MZQTDLL_API void setDropDuplicates(bool drop);
+    //! \brief empty the peaks of degenerate scans instead of flagging them
+    MZQTDLL_API void setDropDegenerate(bool drop);
+    //! \brief number of distinct scans whose peaks are kept to be compared
+    //! with the duplicates to drop, 16 by default
+    MZQTDLL_API void setComparedScans(int numScans);
+
+    //! \brief set the hash and the flags of scan, returns false if the peaks
+    //! of scan have been dropped
+    MZQTDLL_API bool check(Scan &scan);
+
+    //! \brief forget the scans seen so far
+    MZQTDLL_API void clear();
+
+    //! \brief 64 bit hash of the peak arrays
+    MZQTDLL_API static quint64 hash(const double *mz, const double *intensity,
+        int size);
+
+    long duplicateScans_;
+    long degenerateScans_;
+
+  private:
+    struct Peaks {
+      std::vector<double> mz_;
+      std::vector<double> intensity_;
+    };
+
+    void keepPeaks(quint64 hash, const Scan &scan);
+
+    bool dropDuplicates_;
+    bool dropDegenerate_;
+    size_t comparedScans_;
+
+    QSet<quint64> seen_;
+    QHash<quint64, Peaks> peaks_; //!< by hash
+    std::deque<quint64> keptHashes_; //!< oldest first
+  };
+
+}
+
+#endif /* MZQT_SCANHASHER_H_ */
@@ -0,0 +1,262 @@
+/*
+ ScanMerger.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "ScanMerger.h"
+#include "Scan.h"
+#include "Debug.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+namespace {
+
+  struct FragmentPeak {
+    double mz;
+    double intensity;
+    int origin; //!< index of the scan in the cluster
+  };
+
+  bool lessByMZ(const FragmentPeak &a, const FragmentPeak &b)
+  {
+    return a.mz < b.mz;
+  }
+
+}
+
+ScanMerger::ScanMerger() :
+  precursorTolerance_(10.0), retentionTimeWindow_(30.0),
+      fragmentTolerance_(20.0), minPeakFraction_(0.5), minClusterSize_(2),
+      mergedScanCount_(0)
+{
+}
+
+void ScanMerger::setPrecursorTolerance(double ppm)
+{
+  precursorTolerance_ = ppm;
+}
+
+void ScanMerger::setRetentionTimeWindow(double seconds)
+{
+  retentionTimeWindow_ = seconds;
+}
+
+void ScanMerger::setFragmentTolerance(double ppm)
+{
+  fragmentTolerance_ = ppm;
+}
+
+void ScanMerger::setMinPeakFraction(double fraction)
+{
+  minPeakFraction_ = fraction;
+}
+
+void ScanMerger::setMinClusterSize(int size)
+{
+  minClusterSize_ = std::max(size, 2);
+}
+
+void ScanMerger::setParentFileID(const QString &fileID)
+{
+  parentFileID_ = fileID;
+}
+
+bool ScanMerger::addScan(const Scan *scan)
+{
+  if (scan == NULL || scan->msLevel_ < 2 || scan->precursorMZ_ <= 0)
+    return false;
+
+  Entry entry;
+  entry.scan = scan;
+  entry.msLevel = scan->msLevel_;
+  entry.charge = scan->precursorCharge_ > 0 ? scan->precursorCharge_ : 0;
+  entry.precursorMZ = scan->precursorMZ_;
+  entry.retentionTime = scan->retentionTimeInSec_;
+  entries_.push_back(entry);
+
+  return true;
+}
+
+void ScanMerger::clear()
+{
+  entries_.clear();
+}
+
+void ScanMerger::merge(std::vector<Scan *> &merged)
+{
+  // sort on (ms level, charge, precursor m/z): candidates of a group are
+  // then contiguous
+  std::vector<const Entry *> sorted;
+  sorted.reserve(entries_.size());
+  for (size_t i = 0; i < entries_.size(); ++i)
+    sorted.push_back(&entries_[i]);
+
+  std::sort(sorted.begin(), sorted.end(),
+            [](const Entry *a, const Entry *b) {
+              if (a->msLevel != b->msLevel)
+                return a->msLevel < b->msLevel;
+              if (a->charge != b->charge)
+                return a->charge < b->charge;
+              return a->precursorMZ < b->precursorMZ;
+            });
+
+  std::vector<const Entry *> mzGroup, cluster;
+
+  size_t begin = 0;
+  while (begin < sorted.size()) {
+
+    // sweep over m/z: a group is anchored on its lowest precursor m/z
+    const Entry *anchor = sorted[begin];
+    double maxMZ = anchor->precursorMZ * (1.0 + precursorTolerance_ * 1.0e-6);
+    size_t end = begin + 1;
+    while (end < sorted.size() && sorted[end]->msLevel == anchor->msLevel
+        && sorted[end]->charge == anchor->charge
+        && sorted[end]->precursorMZ <= maxMZ) {
+      ++end;
+    }
+
+    if (int(end - begin) >= minClusterSize_) {
+
+      // sweep over retention time inside the m/z group
+      mzGroup.assign(sorted.begin() + begin, sorted.begin() + end);
+      std::sort(mzGroup.begin(), mzGroup.end(),
+                [](const Entry *a, const Entry *b) {
+                  return a->retentionTime < b->retentionTime;
+                });
+
+      size_t first = 0;
+      while (first < mzGroup.size()) {
+        double maxRT = mzGroup[first]->retentionTime + retentionTimeWindow_;
+        size_t last = first + 1;
+        while (last < mzGroup.size() && mzGroup[last]->retentionTime <= maxRT)
+          ++last;
+
+        if (int(last - first) >= minClusterSize_) {
+          cluster.assign(mzGroup.begin() + first, mzGroup.begin() + last);
+          merged.push_back(buildConsensus(cluster));
+        }
+        first = last;
+      }
+    }
+
+    begin = end;
+  }
+
+  Debug::dbg(Debug::MEDIUM) << "merged " << entries_.size()
+      << " MSn scans into " << mergedScanCount_ << " consensus scans"
+      << Debug::ENDL;
+}
+
+Scan *ScanMerger::buildConsensus(const std::vector<const Entry *> &cluster)
+{
+  // the most intense precursor gives the header of the consensus scan
+  const Scan *reference = cluster[0]->scan;
+  size_t numPeaks = 0;
+  for (size_t i = 0; i < cluster.size(); ++i) {
+    const Scan *s = cluster[i]->scan;
+    if (s->precursorIntensity_ > reference->precursorIntensity_
+        || (s->precursorIntensity_ == reference->precursorIntensity_
+            && s->totalIonCurrent_ > reference->totalIonCurrent_)) {
+      reference = s;
+    }
+    numPeaks += s->getNumDataPoints();
+  }
+
+  std::vector<FragmentPeak> peaks;
+  peaks.reserve(numPeaks);
+  for (size_t i = 0; i < cluster.size(); ++i) {
+    const Scan *s = cluster[i]->scan;
+    for (int p = 0; p < s->getNumDataPoints(); ++p) {
+      if (s->intensityArray_[p] <= 0)
+        continue;
+      FragmentPeak peak = { s->mzArray_[p], s->intensityArray_[p], int(i) };
+      peaks.push_back(peak);
+    }
+  }
+  std::sort(peaks.begin(), peaks.end(), lessByMZ);
+
+  // sweep over fragment m/z, keeping peaks found in enough scans
+  int minOrigins = std::max(1, (int) std::ceil(minPeakFraction_
+      * cluster.size() - 1.0e-9));
+  std::vector<int> lastGroup(cluster.size(), -1);
+  std::vector<std::pair<double, double> > consensus;
+
+  size_t begin = 0;
+  int group = 0;
+  while (begin < peaks.size()) {
+    double maxMZ = peaks[begin].mz * (1.0 + fragmentTolerance_ * 1.0e-6);
+    double sumIntensity = 0, sumWeightedMZ = 0;
+    int numOrigins = 0;
+    size_t end = begin;
+    for (; end < peaks.size() && peaks[end].mz <= maxMZ; ++end) {
+      sumIntensity += peaks[end].intensity;
+      sumWeightedMZ += peaks[end].mz * peaks[end].intensity;
+      if (lastGroup[peaks[end].origin] != group) {
+        lastGroup[peaks[end].origin] = group;
+        ++numOrigins;
+      }
+    }
+
+    if (numOrigins >= minOrigins) {
+      consensus.push_back(std::make_pair(sumWeightedMZ / sumIntensity,
+                                         sumIntensity / cluster.size()));
+    }
+
+    begin = end;
+    ++group;
+  }
+
+  Scan *result = new Scan(*reference);
+  result->setNumDataPoints((int) consensus.size());
+
+  result->totalIonCurrent_ = 0;
+  result->basePeakMZ_ = -1;
+  result->basePeakIntensity_ = 0;
+  for (size_t i = 0; i < consensus.size(); ++i) {
+    result->mzArray_[i] = consensus[i].first;
+    result->intensityArray_[i] = consensus[i].second;
+    result->totalIonCurrent_ += consensus[i].second;
+    if (consensus[i].second > result->basePeakIntensity_) {
+      result->basePeakMZ_ = consensus[i].first;
+      result->basePeakIntensity_ = consensus[i].second;
+    }
+  }
+  if (!consensus.empty()) {
+    result->minObservedMZ_ = consensus.front().first;
+    result->maxObservedMZ_ = consensus.back().first;
+  }
+
+  result->isCentroided_ = true;
+  result->isMerged_ = true;
+  result->mergedScanNum_ = ++mergedScanCount_;
+  result->setNumScanOrigins((int) cluster.size());
+  for (size_t i = 0; i < cluster.size(); ++i) {
+    result->scanOriginNums[i] = cluster[i]->scan->scanNumber_;
+    result->scanOriginParentFileIDs[i] = parentFileID_;
+  }
+
+  return result;
+}
@@ -0,0 +1,102 @@
+/*
+ ScanMerger.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef MZQT_SCANMERGER_H_
+#define MZQT_SCANMERGER_H_
+
+#include <vector>
+
+#include <QString>
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+namespace mzqt {
+
+  class Scan;
+
+  /*! Merge redundant MSn scans acquired on the same precursor into a single
+   * consensus spectrum.
+   *
+   * Scans are grouped by ms level, precursor charge, precursor m/z (ppm)
+   * and retention time window. Grouping is done with a sorted sweep, there
+   * is no pairwise comparison between scans.
+   */
+  class ScanMerger {
+
+  public:
+    MZQTDLL_API ScanMerger();
+
+    MZQTDLL_API void setPrecursorTolerance(double ppm);
+    MZQTDLL_API void setRetentionTimeWindow(double seconds);
+    MZQTDLL_API void setFragmentTolerance(double ppm);
+    MZQTDLL_API void setMinPeakFraction(double fraction);
+    MZQTDLL_API void setMinClusterSize(int size);
+    MZQTDLL_API void setParentFileID(const QString &fileID);
+
+    //! \brief register a scan for merging, returns false if the scan is not
+    //! a MSn scan with a precursor. The scan is not copied: it must stay
+    //! alive until merge() returns
+    MZQTDLL_API bool addScan(const Scan *scan);
+    MZQTDLL_API void clear();
+
+    //! \brief append to merged one consensus scan per group of at least
+    //! minClusterSize scans. The caller owns the returned scans
+    MZQTDLL_API void merge(std::vector<Scan *> &merged);
+
+  private:
+
+    struct Entry {
+      const Scan *scan;
+      int msLevel;
+      int charge;
+      double precursorMZ;
+      double retentionTime;
+    };
+
+    Scan *buildConsensus(const std::vector<const Entry *> &cluster);
+
+    double precursorTolerance_; //!< ppm
+    double retentionTimeWindow_; //!< seconds
+    double fragmentTolerance_; //!< ppm
+    double minPeakFraction_; //!< minimum fraction of scans sharing a peak
+    int minClusterSize_;
+    long mergedScanCount_;
+    QString parentFileID_;
+
+    std::vector<Entry> entries_;
+  };
+
+}
+
+#endif /* MZQT_SCANMERGER_H_ */
@@ -0,0 +1,368 @@
+/*
+ ScanPipeline.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "ScanPipeline.h"
+#include "InstrumentInterface.h"
+#include "ConversionCheckpoint.h"
+#include "Scan.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+namespace {
+
+  class FunctionStage: public ScanStage {
+
+  public:
+    explicit FunctionStage(const std::function<void(Scan &)> &function) :
+      function_(function)
+    {
+    }
+    virtual void process(Scan &scan)
+    {
+      function_(scan);
+    }
+
+  private:
+    std::function<void(Scan &)> function_;
+  };
+
+}
+
+ScanStage::~ScanStage()
+{
+}
+
+CentroidStage::CentroidStage(const std::string &instrument) :
+  instrument_(instrument)
+{
+}
+
+void CentroidStage::process(Scan &scan)
+{
+  scan.centroid(instrument_);
+}
+
+ThresholdStage::ThresholdStage(double inclusiveCutoff, bool discard) :
+  cutoff_(inclusiveCutoff), discard_(discard)
+{
+}
+
+void ThresholdStage::process(Scan &scan)
+{
+  scan.threshold(cutoff_, discard_);
+}
+
+/*! State of one ScanPipeline::run().
+ *
+ * Scans are numbered in reading order. Scan seq is queued to worker
+ * seq % numWorkers and its result goes to slot seq % maxInFlight, which is
+ * free since at most maxInFlight scans are in the pipeline.
+ */
+class ScanPipeline::Run {
+
+public:
+  struct Task {
+    long seq;
+    Scan *scan;
+  };
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  struct Slot {
+    Scan *scan;
+    bool ready; //!< protected by mutex_
+  };
+
+  Run(const std::vector<ScanStage *> &stages, int numWorkers, int maxInFlight) :
+    stages_(stages), slots_(new Slot[maxInFlight]), numSlots_(maxInFlight),
+        queued_(0), stolen_(0), stop_(false), failed_(false)
+  {
+    for (int i = 0; i < numSlots_; ++i) {
+      slots_[i].scan = NULL;
+      slots_[i].ready = false;
+    }
+    for (int i = 0; i < numWorkers; ++i)
+      queues_.push_back(std::unique_ptr<Queue>(new Queue));
+    for (int i = 0; i < numWorkers; ++i)
+      threads_.push_back(std::thread(&Run::work, this, i));
+  }
+
+  ~Run()
+  {
+    stopWorkers();
+
+    // scans not given to the sink
+    for (size_t i = 0; i < queues_.size(); ++i)
+      for (size_t j = 0; j < queues_[i]->tasks.size(); ++j)
+        delete queues_[i]->tasks[j].scan;
+    for (int i = 0; i < numSlots_; ++i)
+      if (slots_[i].ready)
+        delete slots_[i].scan;
+  }
+
+  void submit(long seq, Scan *scan)
+  {
+    Queue &queue = *queues_[seq % queues_.size()];
+    {
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      Task task = { seq, scan };
+      queue.tasks.push_back(task);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queued_++;
+    }
+    workCondition_.notify_one();
+  }
+
+  //! \brief result of scan seq, waits for it. Throws the error of a stage
+  Scan *take(long seq)
+  {
+    Slot &slot = slots_[seq % numSlots_];
+    std::exception_ptr error;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      doneCondition_.wait(lock, [&] {
+        return slot.ready || error_;
+      });
+      error = error_;
+    }
+
+    if (error) {
+      stopWorkers();
+      std::rethrow_exception(error);
+    }
+
+    Scan *scan = slot.scan;
+    slot.scan = NULL;
+    slot.ready = false;
+    return scan;
+  }
+
+  long stolen() const
+  {
+    return stolen_;
+  }
+
+private:
+  bool pop(size_t index, Task &task)
+  {
+    Queue &queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+      return false;
+    // oldest first: the sink is waiting for it
+    task = queue.tasks.front();
+    queue.tasks.pop_front();
+    return true;
+  }
+
+  bool steal(size_t index, Task &task)
+  {
+    for (size_t i = 1; i < queues_.size(); ++i) {
+      Queue &queue = *queues_[(index + i) % queues_.size()];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (!queue.tasks.empty()) {
+        // other end than the owner
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+        stolen_++;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void work(size_t index)
+  {
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        workCondition_.wait(lock, [&] {
+          return stop_ || queued_ > 0;
+        });
+        if (stop_)
+          return;
+        queued_--;
+      }
+
+      // a task is reserved for this worker: it is in one of the queues
+      Task task;
+      while (!pop(index, task) && !steal(index, task))
+        std::this_thread::yield();
+
+      try {
+        if (!failed_)
+          for (size_t i = 0; i < stages_.size(); ++i)
+            stages_[i]->process(*task.scan);
+      }
+      catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_)
+          error_ = std::current_exception();
+        failed_ = true;
+      }
+
+      Slot &slot = slots_[task.seq % numSlots_];
+      slot.scan = task.scan;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        slot.ready = true;
+      }
+      doneCondition_.notify_one();
+    }
+  }
+
+  void stopWorkers()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    workCondition_.notify_all();
+    for (size_t i = 0; i < threads_.size(); ++i)
+      if (threads_[i].joinable())
+        threads_[i].join();
+  }
+
+  const std::vector<ScanStage *> &stages_;
+  std::vector<std::unique_ptr<Queue> > queues_;
+  std::vector<std::thread> threads_;
+  std::unique_ptr<Slot[]> slots_;
+  int numSlots_;
+
+  std::mutex mutex_; //!< protects queued_, stop_, error_ and the waits
+  std::condition_variable workCondition_;
+  std::condition_variable doneCondition_;
+  long queued_; //!< tasks not yet reserved by a worker
+  std::atomic<long> stolen_;
+  bool stop_;
+  std::exception_ptr error_;
+  std::atomic<bool> failed_; //!< error_ is set, skip the remaining scans
+};
+
+ScanPipeline::ScanPipeline() :
+  processedScans_(0), stolenScans_(0), numThreads_(0), maxInFlight_(256),
+      checkpoint_(NULL)
+{
+}
+
+ScanPipeline::~ScanPipeline()
+{
+  for (size_t i = 0; i < stages_.size(); ++i)
+    delete stages_[i];
+}
+
+void ScanPipeline::setNumThreads(int numThreads)
+{
+  numThreads_ = numThreads;
+}
+
+void ScanPipeline::setMaxInFlight(int maxInFlight)
+{
+  maxInFlight_ = maxInFlight > 0 ? maxInFlight : 1;
+}
+
+int ScanPipeline::maxInFlight() const
+{
+  return maxInFlight_;
+}
+
+void ScanPipeline::addStage(ScanStage *stage)
+{
+  stages_.push_back(stage);
+}
+
+void ScanPipeline::addStage(const std::function<void(Scan &)> &stage)
+{
+  stages_.push_back(new FunctionStage(stage));
+}
+
+void ScanPipeline::setCheckpoint(ConversionCheckpoint *checkpoint)
+{
+  checkpoint_ = checkpoint;
+}
+
+void ScanPipeline::run(const std::function<Scan *()> &source,
+                       const std::function<void(Scan *)> &sink)
+{
+  int numThreads = numThreads_;
+  if (numThreads <= 0)
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+  Run run(stages_, numThreads, maxInFlight_);
+
+  long read = 0, delivered = 0;
+  bool sourceDone = false;
+  bool draining = false; // checkpoint due, waiting for the scans in flight
+
+  while (!sourceDone || delivered < read) {
+    while (!sourceDone && !draining && read - delivered < maxInFlight_) {
+      Scan *scan = source();
+      if (scan == NULL) {
+        sourceDone = true;
+        break;
+      }
+      // lazy peaks have to be read in this thread, the one of the interface
+      scan->loadPeaks();
+      run.submit(read++, scan);
+    }
+
+    if (delivered < read) {
+      Scan *scan = run.take(delivered++);
+      long scanNumber = scan->scanNumber_;
+      processedScans_++;
+      sink(scan);
+
+      if (checkpoint_ != NULL) {
+        draining = checkpoint_->isDue() && delivered < read;
+        if (!draining)
+          checkpoint_->completed(scanNumber);
+      }
+    }
+  }
+
+  stolenScans_ += run.stolen();
+}
+
+void ScanPipeline::run(InstrumentInterface &iface,
+                       const std::function<void(Scan *)> &sink)
+{
+  run([&iface]() {
+    return iface.getScan();
+  }, sink);
+}
@@ -0,0 +1,151 @@
+/*
+ ScanPipeline.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_SCANPIPELINE_H_
+#define MZQT_SCANPIPELINE_H_
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+namespace mzqt {
+
+  class Scan;
+  class InstrumentInterface;
+  class ConversionCheckpoint;
+
+  /*! Processing applied to each scan by ScanPipeline.
+   *
+   * process() is called from several threads at once, on different scans:
+   * it must not modify the stage.
+   */
+  class ScanStage {
+
+  public:
+    MZQTDLL_API virtual ~ScanStage();
+    MZQTDLL_API virtual void process(Scan &scan) = 0;
+  };
+
+  //! Scan::centroid()
+  class CentroidStage: public ScanStage {
+
+  public:
+    MZQTDLL_API explicit CentroidStage(const std::string &instrument = "");
+    MZQTDLL_API virtual void process(Scan &scan);
+
+  private:
+    std::string instrument_;
+  };
+
+  //! Scan::threshold()
+  class ThresholdStage: public ScanStage {
+
+  public:
+    MZQTDLL_API ThresholdStage(double inclusiveCutoff, bool discard);
+    MZQTDLL_API virtual void process(Scan &scan);
+
+  private:
+    double cutoff_;
+    bool discard_;
+  };
+
+  /*! Run a chain of ScanStage on a pool of threads.
+   *
+   * run() reads the scans from a source in the calling thread, hands them
+   * to the worker threads and gives them to the sink, in the calling
+   * thread, in the order they have been read. Each worker has its own
+   * queue and steals from the others when it runs out of scans, so that
+   * slow scans do not leave threads idle. At most maxInFlight() scans are
+   * read and not yet given to the sink.
+   *
+   *   ScanPipeline pipeline;
+   *   pipeline.addStage(new CentroidStage());
+   *   pipeline.addStage(new ThresholdStage(100, true));
+   *   pipeline.run(iface, [&](Scan *scan) { writer.write(*scan); delete scan; });
+   *
+   * The source can be a PrefetchReader to overlap the reading with the
+   * processing as well.
+   */
+  class ScanPipeline {
+
+  public:
+    MZQTDLL_API ScanPipeline();
+    MZQTDLL_API ~ScanPipeline();
+
+    //! \brief 0 for one thread per core
+    MZQTDLL_API void setNumThreads(int numThreads);
+    MZQTDLL_API void setMaxInFlight(int maxInFlight);
+    MZQTDLL_API int maxInFlight() const;
+
+    //! \brief stages are run in the order they are added, the pipeline
+    //! takes the ownership
+    MZQTDLL_API void addStage(ScanStage *stage);
+    MZQTDLL_API void addStage(const std::function<void(Scan &)> &stage);
+
+    //! \brief give the scans to checkpoint once the sink returns. When a
+    //! checkpoint is due, no scan is read until the ones in flight are
+    //! given to the sink, so that the state saved is the one of the last
+    //! scan written. Not owned, NULL for no checkpoints
+    MZQTDLL_API void setCheckpoint(ConversionCheckpoint *checkpoint);
+
+    //! \brief process the scans of source until it returns NULL. The sink
+    //! takes the ownership of the scans. An exception thrown by a stage is
+    //! thrown again here once the workers are stopped
+    MZQTDLL_API void run(const std::function<Scan *()> &source,
+        const std::function<void(Scan *)> &sink);
+    //! \brief process the scans returned by iface.getScan()
+    MZQTDLL_API void run(InstrumentInterface &iface,
+        const std::function<void(Scan *)> &sink);
+
+    long processedScans_;
+    long stolenScans_; //!< processed by another worker than the one given
+
+  private:
+    ScanPipeline(const ScanPipeline &); // intentionally undefined
+    ScanPipeline &operator=(const ScanPipeline &); // intentionally undefined
+
+    class Run;
+
+    int numThreads_;
+    int maxInFlight_;
+    std::vector<ScanStage *> stages_;
+    ConversionCheckpoint *checkpoint_;
+  };
+
+}
+
+#endif /* MZQT_SCANPIPELINE_H_ */
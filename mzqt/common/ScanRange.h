@@ -0,0 +1,303 @@
+/*
+ ScanRange.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_SCANRANGE_H_
+#define MZQT_SCANRANGE_H_
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "InstrumentInterface.h"
+#include "Scan.h"
+#include "UVScan.h"
+
+namespace mzqt {
+
+  /*! Input range over the scans returned by a reading method of an
+   * InstrumentInterface, to be used with range-for and the algorithms:
+   *
+   *   for (std::unique_ptr<Scan> &scan : ScanRange(iface))
+   *     process(*scan);
+   *
+   * Each element owns its scan: the scan is deleted when the iterator moves
+   * on unless it has been moved out. Like getScan(), the range only goes
+   * forward: begin() starts from the current position of the interface.
+   * The copies of an iterator share its position, like those of an
+   * std::istream_iterator, and it++ returns the element it leaves:
+   *
+   *   std::vector<std::unique_ptr<Scan> > scans(
+   *       std::make_move_iterator(range.begin()),
+   *       std::make_move_iterator(range.end()));
+   */
+  template<typename T, T *(InstrumentInterface::*Next)()>
+  class InterfaceRange {
+
+  public:
+    class iterator {
+
+    public:
+      typedef std::input_iterator_tag iterator_category;
+      typedef std::unique_ptr<T> value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef std::unique_ptr<T> *pointer;
+      typedef std::unique_ptr<T> &reference;
+
+      //! \brief result of it++, owns the element left behind
+      class proxy {
+
+      public:
+        explicit proxy(value_type &value) :
+          value_(std::move(value))
+        {
+        }
+
+        reference operator*()
+        {
+          return value_;
+        }
+
+      private:
+        value_type value_;
+      };
+
+      iterator()
+      {
+      }
+      explicit iterator(InstrumentInterface *iface) :
+        cursor_(new Cursor)
+      {
+        cursor_->iface_ = iface;
+        read();
+      }
+
+      reference operator*() const
+      {
+        return cursor_->current_;
+      }
+      pointer operator->() const
+      {
+        return &cursor_->current_;
+      }
+      iterator &operator++()
+      {
+        read();
+        return *this;
+      }
+      proxy operator++(int)
+      {
+        proxy left(cursor_->current_);
+        read();
+        return left;
+      }
+
+      //! \brief the copies of an iterator are equal, all the iterators are
+      //! equal at the end
+      bool operator==(const iterator &other) const
+      {
+        return atEnd() ? other.atEnd() : cursor_ == other.cursor_;
+      }
+      bool operator!=(const iterator &other) const
+      {
+        return !(*this == other);
+      }
+
+    private:
+      struct Cursor {
+        InstrumentInterface *iface_; //!< NULL at the end
+        value_type current_;
+      };
+
+      bool atEnd() const
+      {
+        return !cursor_ || cursor_->iface_ == NULL;
+      }
+      void read()
+      {
+        cursor_->current_.reset((cursor_->iface_->*Next)());
+        if (!cursor_->current_)
+          cursor_->iface_ = NULL;
+      }
+
+      std::shared_ptr<Cursor> cursor_; //!< shared by the copies, NULL for end()
+    };
+
+    explicit InterfaceRange(InstrumentInterface &iface) :
+      iface_(iface)
+    {
+    }
+
+    iterator begin()
+    {
+      return iterator(&iface_);
+    }
+    iterator end()
+    {
+      return iterator();
+    }
+
+  private:
+    InstrumentInterface &iface_;
+  };
+
+  typedef InterfaceRange<Scan, &InstrumentInterface::getScan> ScanRange;
+  typedef InterfaceRange<UVScan, &InstrumentInterface::getUVScan> UVScanRange;
+
+  /*! Input range over chunks of consecutive scans.
+   *
+   * Each chunk is a vector of owned scans, which has random access
+   * iterators, so the scans of a chunk can be processed by the parallel
+   * algorithms while the reading stays in the calling thread:
+   *
+   *   for (ScanChunks::Chunk &chunk : ScanChunks(iface, 64))
+   *     std::for_each(std::execution::par, chunk.begin(), chunk.end(),
+   *                   [](std::unique_ptr<Scan> &scan) { process(*scan); });
+   *
+   * Lazy peaks are read before a chunk is returned: the scans can be used
+   * from any thread. The scans of a chunk are deleted when the next one is
+   * read. The iterators are copied and incremented like those of
+   * InterfaceRange.
+   */
+  class ScanChunks {
+
+  public:
+    typedef std::vector<std::unique_ptr<Scan> > Chunk;
+
+    class iterator {
+
+    public:
+      typedef std::input_iterator_tag iterator_category;
+      typedef Chunk value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef Chunk *pointer;
+      typedef Chunk &reference;
+
+      //! \brief result of it++, owns the chunk left behind
+      class proxy {
+
+      public:
+        explicit proxy(Chunk &chunk)
+        {
+          chunk_.swap(chunk);
+        }
+
+        reference operator*()
+        {
+          return chunk_;
+        }
+
+      private:
+        Chunk chunk_;
+      };
+
+      iterator()
+      {
+      }
+      iterator(InstrumentInterface *iface, size_t size) :
+        cursor_(new Cursor)
+      {
+        cursor_->iface_ = iface;
+        cursor_->size_ = size;
+        read();
+      }
+
+      reference operator*() const
+      {
+        return cursor_->chunk_;
+      }
+      pointer operator->() const
+      {
+        return &cursor_->chunk_;
+      }
+      iterator &operator++()
+      {
+        read();
+        return *this;
+      }
+      proxy operator++(int)
+      {
+        proxy left(cursor_->chunk_);
+        read();
+        return left;
+      }
+
+      bool operator==(const iterator &other) const
+      {
+        return atEnd() ? other.atEnd() : cursor_ == other.cursor_;
+      }
+      bool operator!=(const iterator &other) const
+      {
+        return !(*this == other);
+      }
+
+    private:
+      struct Cursor {
+        InstrumentInterface *iface_; //!< NULL at the end
+        size_t size_;
+        Chunk chunk_;
+      };
+
+      bool atEnd() const
+      {
+        return !cursor_ || cursor_->iface_ == NULL;
+      }
+      void read()
+      {
+        Chunk &chunk = cursor_->chunk_;
+        chunk.clear();
+        chunk.reserve(cursor_->size_);
+        while (chunk.size() < cursor_->size_) {
+          Scan *scan = cursor_->iface_->getScan();
+          if (scan == NULL)
+            break;
+          scan->loadPeaks();
+          chunk.push_back(std::unique_ptr<Scan>(scan));
+        }
+        if (chunk.empty())
+          cursor_->iface_ = NULL;
+      }
+
+      std::shared_ptr<Cursor> cursor_; //!< shared by the copies, NULL for end()
+    };
+
+    ScanChunks(InstrumentInterface &iface, size_t chunkSize) :
+      iface_(iface), chunkSize_(chunkSize > 0 ? chunkSize : 1)
+    {
+    }
+
+    iterator begin()
+    {
+      return iterator(&iface_, chunkSize_);
+    }
+    iterator end()
+    {
+      return iterator();
+    }
+
+  private:
+    InstrumentInterface &iface_;
+    size_t chunkSize_;
+  };
+
+}
+
+#endif /* MZQT_SCANRANGE_H_ */
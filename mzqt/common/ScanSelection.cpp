@@ -0,0 +1,169 @@
+/*
+ ScanSelection.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <algorithm>
+
+#include "ScanSelection.h"
+#include "Scan.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+ScanSelection::ScanSelection()
+{
+  clear();
+}
+
+void ScanSelection::clear()
+{
+  msLevels_.clear();
+  minTime_ = -1;
+  maxTime_ = -1;
+  polarity_ = POLARITY_UNDEF;
+  filter_ = QRegularExpression();
+  hasFilter_ = false;
+  minMZ_ = -1;
+  maxMZ_ = -1;
+}
+
+bool ScanSelection::isEmpty() const
+{
+  return msLevels_.isEmpty() && minTime_ < 0 && maxTime_ < 0
+      && (polarity_ == POLARITY_UNDEF || polarity_ == ANY) && !hasFilter_
+      && !hasMZRange();
+}
+
+void ScanSelection::addMSLevel(int msLevel)
+{
+  msLevels_.insert(msLevel);
+}
+
+void ScanSelection::setRetentionTimeRange(double minTime, double maxTime)
+{
+  minTime_ = minTime;
+  maxTime_ = maxTime;
+}
+
+void ScanSelection::setPolarity(MSPolarityType polarity)
+{
+  polarity_ = polarity;
+}
+
+void ScanSelection::setFilter(const QString &pattern)
+{
+  hasFilter_ = !pattern.isEmpty();
+  filter_ = QRegularExpression(pattern);
+  filter_.optimize();
+}
+
+void ScanSelection::setMZRange(double minMZ, double maxMZ)
+{
+  minMZ_ = minMZ;
+  maxMZ_ = maxMZ;
+}
+
+bool ScanSelection::acceptsMSLevel(int msLevel) const
+{
+  return msLevels_.isEmpty() || msLevels_.contains(msLevel);
+}
+
+bool ScanSelection::acceptsRetentionTime(double timeInSec) const
+{
+  return (minTime_ < 0 || timeInSec >= minTime_) && (maxTime_ < 0
+      || timeInSec <= maxTime_);
+}
+
+bool ScanSelection::isPastRetentionTime(double timeInSec) const
+{
+  return maxTime_ >= 0 && timeInSec > maxTime_;
+}
+
+bool ScanSelection::acceptsPolarity(MSPolarityType polarity) const
+{
+  if (polarity_ == POLARITY_UNDEF || polarity_ == ANY)
+    return true;
+  return polarity == POLARITY_UNDEF || polarity == ANY || polarity == polarity_;
+}
+
+bool ScanSelection::acceptsFilter(const QString &filterLine) const
+{
+  if (!hasFilter_ || filterLine.isEmpty())
+    return true;
+  return filter_.match(filterLine).hasMatch();
+}
+
+bool ScanSelection::acceptsMZRange(double startMZ, double endMZ) const
+{
+  if (!hasMZRange() || endMZ <= 0)
+    return true;
+  return endMZ >= minMZ_ && startMZ <= maxMZ_;
+}
+
+bool ScanSelection::accepts(const Scan &scan) const
+{
+  return acceptsMSLevel(scan.msLevel_) && acceptsPolarity(scan.polarity_)
+      && acceptsRetentionTime(scan.retentionTimeInSec_)
+      && acceptsFilter(scan.thermoFilterLine_) && acceptsMZRange(scan.startMZ_,
+                                                                 scan.endMZ_);
+}
+
+bool ScanSelection::hasMZRange() const
+{
+  return maxMZ_ > 0;
+}
+
+double ScanSelection::minMZ() const
+{
+  return minMZ_;
+}
+
+double ScanSelection::maxMZ() const
+{
+  return maxMZ_;
+}
+
+void ScanSelection::trimPeaks(Scan &scan) const
+{
+  if (!hasMZRange())
+    return;
+
+  double *mz, *intensity;
+  scan.getMZArray(&mz);
+  scan.getIntensityArray(&intensity);
+  int numPoints = scan.getNumDataPoints();
+
+  int first = std::lower_bound(mz, mz + numPoints, minMZ_) - mz;
+  int last = std::upper_bound(mz + first, mz + numPoints, maxMZ_) - mz;
+  if (first == 0 && last == numPoints)
+    return;
+
+  std::copy(mz + first, mz + last, mz);
+  std::copy(intensity + first, intensity + last, intensity);
+  scan.resetNumDataPoints(last - first);
+
+  if (last > first) {
+    scan.minObservedMZ_ = mz[0];
+    scan.maxObservedMZ_ = mz[last - first - 1];
+  }
+}
@@ -0,0 +1,114 @@
+/*
+ ScanSelection.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_SCANSELECTION_H_
+#define MZQT_SCANSELECTION_H_
+
+#include <QSet>
+#include <QString>
+#include <QRegularExpression>
+
+#include "MSTypes.h"
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+namespace mzqt {
+
+  class Scan;
+
+  /*! Scans to be returned by InstrumentInterface::getScan().
+   *
+   * Each test is split so that the backends can apply it to the cheapest
+   * data they have (header table, parsed filter line) before reading the
+   * peaks. An empty selection accepts every scan. The m/z window both
+   * rejects the scans whose scan range is outside it and restricts the
+   * peaks read to it.
+   */
+  class ScanSelection {
+
+  public:
+    MZQTDLL_API ScanSelection();
+
+    //! \brief accept every scan
+    MZQTDLL_API void clear();
+    MZQTDLL_API bool isEmpty() const;
+
+    MZQTDLL_API void addMSLevel(int msLevel);
+    //! \brief in seconds, a negative bound is not checked
+    MZQTDLL_API void setRetentionTimeRange(double minTime, double maxTime);
+    //! \brief POLARITY_UNDEF or ANY for both
+    MZQTDLL_API void setPolarity(MSPolarityType polarity);
+    //! \brief regular expression searched in the Thermo filter line, scans
+    //! without filter line are not tested
+    MZQTDLL_API void setFilter(const QString &pattern);
+    MZQTDLL_API void setMZRange(double minMZ, double maxMZ);
+
+    MZQTDLL_API bool acceptsMSLevel(int msLevel) const;
+    MZQTDLL_API bool acceptsRetentionTime(double timeInSec) const;
+    //! \brief scans of unknown polarity are accepted
+    MZQTDLL_API bool acceptsPolarity(MSPolarityType polarity) const;
+    MZQTDLL_API bool acceptsFilter(const QString &filterLine) const;
+    //! \brief false if the scan range [startMZ, endMZ] is outside the m/z
+    //! window, unknown ranges (endMZ <= 0) are accepted
+    MZQTDLL_API bool acceptsMZRange(double startMZ, double endMZ) const;
+
+    //! \brief true once timeInSec is past the end of the time range: scans
+    //! are read in time order, none of the next ones can be accepted
+    MZQTDLL_API bool isPastRetentionTime(double timeInSec) const;
+
+    //! \brief all the tests on the header of scan
+    MZQTDLL_API bool accepts(const Scan &scan) const;
+
+    MZQTDLL_API bool hasMZRange() const;
+    MZQTDLL_API double minMZ() const;
+    MZQTDLL_API double maxMZ() const;
+    //! \brief remove the peaks outside the m/z window, for backends which
+    //! cannot read a mass range
+    MZQTDLL_API void trimPeaks(Scan &scan) const;
+
+  private:
+    QSet<int> msLevels_; //!< empty for all
+    double minTime_;
+    double maxTime_;
+    MSPolarityType polarity_;
+    QRegularExpression filter_;
+    bool hasFilter_;
+    double minMZ_;
+    double maxMZ_;
+  };
+
+}
+
+#endif /* MZQT_SCANSELECTION_H_ */
@@ -0,0 +1,75 @@
+/*
+ ScanVisitor.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "ScanVisitor.h"
+#include "Scan.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+ScanHeader::ScanHeader() :
+  scanNumber_(-1), msLevel_(0), retentionTimeInSec_(-1),
+      polarity_(POLARITY_UNDEF), analyzer_(ANALYZER_UNDEF),
+      ionization_(IONIZATION_UNDEF), scanType_(SCAN_UNDEF),
+      activation_(ACTIVATION_UNDEF), isCentroided_(false), startMZ_(-1),
+      endMZ_(-1), minObservedMZ_(-1), maxObservedMZ_(-1), basePeakMZ_(-1),
+      basePeakIntensity_(-1), totalIonCurrent_(-1), precursorScanNumber_(-1),
+      precursorCharge_(-1), precursorMZ_(-1), precursorIntensity_(-1),
+      collisionEnergy_(-1)
+{
+}
+
+void ScanHeader::assign(const Scan &scan)
+{
+  scanNumber_ = scan.scanNumber_;
+  msLevel_ = scan.msLevel_;
+  retentionTimeInSec_ = scan.retentionTimeInSec_;
+
+  polarity_ = scan.polarity_;
+  analyzer_ = scan.analyzer_;
+  ionization_ = scan.ionization_;
+  scanType_ = scan.scanType_;
+  activation_ = scan.activation_;
+  isCentroided_ = scan.isCentroided_;
+
+  startMZ_ = scan.startMZ_;
+  endMZ_ = scan.endMZ_;
+  minObservedMZ_ = scan.minObservedMZ_;
+  maxObservedMZ_ = scan.maxObservedMZ_;
+  basePeakMZ_ = scan.basePeakMZ_;
+  basePeakIntensity_ = scan.basePeakIntensity_;
+  totalIonCurrent_ = scan.totalIonCurrent_;
+
+  precursorScanNumber_ = scan.precursorScanNumber_;
+  precursorCharge_ = scan.precursorCharge_;
+  precursorMZ_ = scan.precursorMZ_;
+  precursorIntensity_ = scan.precursorIntensity_;
+  collisionEnergy_ = scan.collisionEnergy_;
+
+  thermoFilterLine_ = scan.thermoFilterLine_;
+}
+
+ScanVisitor::~ScanVisitor()
+{
+}
@@ -0,0 +1,147 @@
+/*
+ ScanVisitor.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_SCANVISITOR_H_
+#define MZQT_SCANVISITOR_H_
+
+#include <cstddef>
+#include <QString>
+
+#include "MSTypes.h"
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+namespace mzqt {
+
+  class Scan;
+
+  //! read only view of a buffer owned by somebody else
+  template<typename T>
+  class Span {
+
+  public:
+    Span() :
+      data_(NULL), size_(0)
+    {
+    }
+    Span(T *data, size_t size) :
+      data_(data), size_(size)
+    {
+    }
+
+    T *data() const
+    {
+      return data_;
+    }
+    size_t size() const
+    {
+      return size_;
+    }
+    bool empty() const
+    {
+      return size_ == 0;
+    }
+    T &operator[](size_t i) const
+    {
+      return data_[i];
+    }
+    T *begin() const
+    {
+      return data_;
+    }
+    T *end() const
+    {
+      return data_ + size_;
+    }
+
+  private:
+    T *data_;
+    size_t size_;
+  };
+
+  //! the fields of Scan which do not depend on the peaks
+  struct ScanHeader {
+    long scanNumber_;
+    int msLevel_;
+    double retentionTimeInSec_;
+
+    MSPolarityType polarity_;
+    MSAnalyzerType analyzer_;
+    MSIonizationType ionization_;
+    MSScanType scanType_;
+    MSActivationType activation_;
+    bool isCentroided_;
+
+    double startMZ_;
+    double endMZ_;
+    double minObservedMZ_;
+    double maxObservedMZ_;
+    double basePeakMZ_;
+    double basePeakIntensity_;
+    double totalIonCurrent_;
+
+    long precursorScanNumber_;
+    int precursorCharge_;
+    double precursorMZ_;
+    double precursorIntensity_;
+    double collisionEnergy_;
+
+    QString thermoFilterLine_;
+
+    MZQTDLL_API ScanHeader();
+    MZQTDLL_API void assign(const Scan &scan);
+  };
+
+  /*! Receive the scans of InstrumentInterface::visitScans() without any
+   * Scan object.
+   *
+   * For each scan onHeader() is called first, then onPeaks() with views of
+   * the buffers of the backend, valid only during the call. The backend
+   * does not hash, copy or own the peaks.
+   */
+  class ScanVisitor {
+
+  public:
+    MZQTDLL_API virtual ~ScanVisitor();
+
+    //! \brief return false to skip the peaks of this scan
+    MZQTDLL_API virtual bool onHeader(const ScanHeader &header) = 0;
+    MZQTDLL_API virtual void onPeaks(Span<const double> mz,
+        Span<const double> intensity) = 0;
+  };
+
+}
+
+#endif /* MZQT_SCANVISITOR_H_ */
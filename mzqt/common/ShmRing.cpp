@@ -0,0 +1,237 @@
+/*
+ ShmRing.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <atomic>
+#include <cstring>
+#include <new>
+
+#include "ShmRing.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+namespace {
+
+  //! the record does not fit before the end: next one at the beginning
+  const quint32 WRAP_MARKER = 0xffffffff;
+  const size_t ERROR_SIZE = 512;
+
+  enum RingState {
+    RING_OPEN, RING_CLOSED
+  };
+
+  //! records start on 8 bytes boundaries, the length included
+  size_t recordSize(size_t length)
+  {
+    return (sizeof(quint32) + length + 7) & ~size_t(7);
+  }
+
+}
+
+// the positions are byte counts since the creation, the offset in the ring
+// is the position modulo size_. Both sides map the same layout: positions
+// must not depend on a lock
+struct ShmRing::Header {
+  alignas(64) std::atomic<quint64> head_; // written by the producer
+  alignas(64) std::atomic<quint64> tail_; // written by the consumer
+  std::atomic<int> closed_;
+  std::atomic<int> cancelled_;
+  quint64 size_;
+  char error_[ERROR_SIZE];
+};
+
+// the positions and flags are shared between processes: an atomic with a
+// lock would keep its lock in the memory of one process only
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+    "lock-free atomics are needed in shared memory");
+
+ShmRing::ShmRing(const QString &key) :
+  memory_(key)
+{
+}
+
+ShmRing::~ShmRing()
+{
+  detach();
+}
+
+bool ShmRing::create(size_t size)
+{
+  size = (size + 7) & ~size_t(7);
+  if (memory_.create(int(sizeof(Header) + size)) == false)
+    return false;
+
+  // nobody attaches before the key is given to the producer
+  Header *h = new (memory_.data()) Header;
+  h->head_.store(0);
+  h->tail_.store(0);
+  h->closed_.store(RING_OPEN);
+  h->cancelled_.store(0);
+  h->size_ = size;
+  h->error_[0] = '\0';
+
+  return checkLockFree();
+}
+
+bool ShmRing::attach()
+{
+  return memory_.attach() && checkLockFree();
+}
+
+bool ShmRing::checkLockFree()
+{
+  // also checked on the mapped objects, in case the segment is misaligned
+  Header *h = header();
+  if (h->head_.is_lock_free() && h->closed_.is_lock_free())
+    return true;
+
+  errorString_ = "lock-free atomics are not available";
+  detach();
+  return false;
+}
+
+void ShmRing::detach()
+{
+  if (memory_.isAttached())
+    memory_.detach();
+}
+
+bool ShmRing::isAttached() const
+{
+  return memory_.isAttached();
+}
+
+QString ShmRing::key() const
+{
+  return memory_.key();
+}
+
+QString ShmRing::errorString() const
+{
+  return errorString_.isEmpty() ? memory_.errorString() : errorString_;
+}
+
+ShmRing::Header *ShmRing::header() const
+{
+  return static_cast<Header *> (memory_.data());
+}
+
+char *ShmRing::records() const
+{
+  return static_cast<char *> (memory_.data()) + sizeof(Header);
+}
+
+size_t ShmRing::maxRecordSize() const
+{
+  // at most half of the ring is skipped by a wrap, so that a record this
+  // large fits in an empty ring wherever the positions are
+  return size_t(header()->size_ / 2) - sizeof(quint32) - 8;
+}
+
+bool ShmRing::push(const QByteArray &record)
+{
+  Header *h = header();
+  quint64 size = h->size_;
+  quint64 head = h->head_.load(std::memory_order_relaxed);
+  quint64 tail = h->tail_.load(std::memory_order_acquire);
+
+  size_t needed = recordSize(record.size());
+  quint64 offset = head % size;
+  quint64 skip = size - offset < needed ? size - offset : 0;
+  if (head + skip + needed - tail > size)
+    return false;
+
+  char *data = records();
+  if (skip > 0) {
+    std::memcpy(data + offset, &WRAP_MARKER, sizeof(quint32));
+    head += skip;
+    offset = 0;
+  }
+
+  quint32 length = quint32(record.size());
+  std::memcpy(data + offset, &length, sizeof(quint32));
+  std::memcpy(data + offset + sizeof(quint32), record.constData(), length);
+  h->head_.store(head + needed, std::memory_order_release);
+
+  return true;
+}
+
+void ShmRing::close(const QString &error)
+{
+  Header *h = header();
+  QByteArray message = error.toUtf8();
+  size_t length = qMin(size_t(message.size()), ERROR_SIZE - 1);
+  std::memcpy(h->error_, message.constData(), length);
+  h->error_[length] = '\0';
+  h->closed_.store(RING_CLOSED, std::memory_order_release);
+}
+
+bool ShmRing::pop(QByteArray &record)
+{
+  Header *h = header();
+  quint64 size = h->size_;
+  quint64 tail = h->tail_.load(std::memory_order_relaxed);
+  quint64 head = h->head_.load(std::memory_order_acquire);
+  if (tail == head)
+    return false;
+
+  const char *data = records();
+  quint64 offset = tail % size;
+  quint32 length;
+  std::memcpy(&length, data + offset, sizeof(quint32));
+  if (length == WRAP_MARKER) {
+    // the record was published with the marker
+    tail += size - offset;
+    offset = 0;
+    std::memcpy(&length, data, sizeof(quint32));
+  }
+
+  record = QByteArray(data + offset + sizeof(quint32), int(length));
+  h->tail_.store(tail + recordSize(length), std::memory_order_release);
+
+  return true;
+}
+
+bool ShmRing::isClosed() const
+{
+  return header()->closed_.load(std::memory_order_acquire) == RING_CLOSED;
+}
+
+QString ShmRing::error() const
+{
+  if (!isClosed())
+    return QString();
+
+  return QString::fromUtf8(header()->error_);
+}
+
+void ShmRing::cancel()
+{
+  header()->cancelled_.store(1, std::memory_order_release);
+}
+
+bool ShmRing::isCancelled() const
+{
+  return header()->cancelled_.load(std::memory_order_acquire) != 0;
+}
@@ -0,0 +1,104 @@
+/*
+ ShmRing.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_SHMRING_H_
+#define MZQT_SHMRING_H_
+
+#include <QByteArray>
+#include <QSharedMemory>
+#include <QString>
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+namespace mzqt {
+
+  /*! Ring of variable size records in a QSharedMemory segment, written by
+   * one process and read by another one: the SpscRing of two processes.
+   *
+   * The owner creates the segment and reads, the producer attaches to it by
+   * key. Neither side blocks: push() and pop() return false when the ring
+   * is full or empty. The producer closes the ring after its last record,
+   * with an error message if it failed; the consumer cancels it to make the
+   * producer stop early.
+   */
+  class ShmRing {
+
+  public:
+    MZQTDLL_API explicit ShmRing(const QString &key);
+    MZQTDLL_API ~ShmRing();
+
+    //! \brief create the segment for size bytes of records
+    MZQTDLL_API bool create(size_t size);
+    //! \brief attach to the segment created by another process
+    MZQTDLL_API bool attach();
+    MZQTDLL_API void detach();
+    MZQTDLL_API bool isAttached() const;
+    MZQTDLL_API QString key() const;
+    MZQTDLL_API QString errorString() const;
+
+    //! \brief larger records never fit
+    MZQTDLL_API size_t maxRecordSize() const;
+
+    //! \brief false if the ring is full. Empty records are allowed
+    MZQTDLL_API bool push(const QByteArray &record);
+    //! \brief no push() after close()
+    MZQTDLL_API void close(const QString &error = QString());
+
+    //! \brief false if the ring is empty
+    MZQTDLL_API bool pop(QByteArray &record);
+    //! \brief once true, the records left are the last ones
+    MZQTDLL_API bool isClosed() const;
+    //! \brief error given to close(), empty if none
+    MZQTDLL_API QString error() const;
+
+    MZQTDLL_API void cancel();
+    MZQTDLL_API bool isCancelled() const;
+
+  private:
+    ShmRing(const ShmRing &); // intentionally undefined
+    ShmRing &operator=(const ShmRing &); // intentionally undefined
+
+    struct Header;
+    Header *header() const;
+    char *records() const;
+    bool checkLockFree();
+
+    mutable QSharedMemory memory_;
+    QString errorString_;
+  };
+
+}
+
+#endif /* MZQT_SHMRING_H_ */
@@ -0,0 +1,171 @@
+/*
+ SpectrumCache.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>
+
+#include "SpectrumCache.h"
+#include "Scan.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+CachedSpectrum::CachedSpectrum() :
+  scanNumber_(-1), retentionTimeInSec_(-1), lastUse_(0)
+{
+}
+
+size_t CachedSpectrum::lowerBound(double mz) const
+{
+  return std::lower_bound(mz_.begin(), mz_.end(), mz) - mz_.begin();
+}
+
+long CachedSpectrum::mostIntensePeak(double lowMZ, double highMZ) const
+{
+  long best = -1;
+  double bestIntensity = 0;
+  for (size_t i = lowerBound(lowMZ); i < mz_.size() && mz_[i] <= highMZ; ++i) {
+    if (intensity_[i] > bestIntensity) {
+      bestIntensity = intensity_[i];
+      best = (long) i;
+    }
+  }
+
+  return best;
+}
+
+double CachedSpectrum::sumIntensity(double lowMZ, double highMZ) const
+{
+  double sum = 0;
+  for (size_t i = lowerBound(lowMZ); i < mz_.size() && mz_[i] <= highMZ; ++i)
+    sum += intensity_[i];
+
+  return sum;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+SpectrumCache::SpectrumCache(size_t capacity) :
+  capacity_(std::max<size_t>(capacity, 1)), useCounter_(0)
+{
+  // never reallocate on insert: returned pointers stay valid
+  entries_.reserve(capacity_);
+}
+
+void SpectrumCache::setCapacity(size_t capacity)
+{
+  capacity_ = std::max<size_t>(capacity, 1);
+  if (entries_.size() > capacity_)
+    entries_.resize(capacity_);
+  entries_.reserve(capacity_);
+}
+
+size_t SpectrumCache::capacity() const
+{
+  return capacity_;
+}
+
+void SpectrumCache::clear()
+{
+  // keep the buffers for later insertions
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    entries_[i].scanNumber_ = -1;
+    entries_[i].mz_.clear();
+    entries_[i].intensity_.clear();
+    entries_[i].lastUse_ = 0;
+  }
+}
+
+const CachedSpectrum *SpectrumCache::insert(const Scan &scan)
+{
+  // first: a header-only scan gets its arrays here
+  int size = scan.getNumDataPoints();
+  return insert(scan.scanNumber_, scan.retentionTimeInSec_, scan.mzArray_,
+                scan.intensityArray_, size);
+}
+
+const CachedSpectrum *SpectrumCache::insert(long scanNumber,
+    double retentionTimeInSec, const double *mz, const double *intensity,
+    size_t size)
+{
+  CachedSpectrum *entry = slotForInsert(scanNumber);
+
+  entry->scanNumber_ = scanNumber;
+  entry->retentionTimeInSec_ = retentionTimeInSec;
+  entry->mz_.assign(mz, mz + size);
+  entry->intensity_.assign(intensity, intensity + size);
+  touch(*entry);
+
+  return entry;
+}
+
+const CachedSpectrum *SpectrumCache::find(long scanNumber)
+{
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    if (entries_[i].scanNumber_ == scanNumber && scanNumber != -1) {
+      touch(entries_[i]);
+      return &entries_[i];
+    }
+  }
+
+  return NULL;
+}
+
+const CachedSpectrum *SpectrumCache::findPrevious(long scanNumber)
+{
+  CachedSpectrum *best = NULL;
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    CachedSpectrum &entry = entries_[i];
+    if (entry.scanNumber_ == -1 || entry.scanNumber_ >= scanNumber)
+      continue;
+    if (best == NULL || entry.scanNumber_ > best->scanNumber_)
+      best = &entry;
+  }
+
+  if (best)
+    touch(*best);
+
+  return best;
+}
+
+CachedSpectrum *SpectrumCache::slotForInsert(long scanNumber)
+{
+  // replace an entry of the same scan, else fill or recycle the oldest one
+  CachedSpectrum *oldest = NULL;
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    if (entries_[i].scanNumber_ == scanNumber)
+      return &entries_[i];
+    if (oldest == NULL || entries_[i].lastUse_ < oldest->lastUse_)
+      oldest = &entries_[i];
+  }
+
+  if (entries_.size() < capacity_) {
+    entries_.push_back(CachedSpectrum());
+    return &entries_.back();
+  }
+
+  return oldest;
+}
+
+void SpectrumCache::touch(CachedSpectrum &entry)
+{
+  entry.lastUse_ = ++useCounter_;
+}
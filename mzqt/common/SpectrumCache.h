@@ -0,0 +1,120 @@
+/*
+ SpectrumCache.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef MZQT_SPECTRUMCACHE_H_
+#define MZQT_SPECTRUMCACHE_H_
+
+#include <vector>
+#include <cstddef>
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+namespace mzqt {
+
+  class Scan;
+
+  //! mass difference between the 13C and 12C isotopes
+  const double ISOTOPE_SPACING = 1.0033548378;
+
+  /*! Spectrum kept in memory, m/z sorted in increasing order
+   */
+  class CachedSpectrum {
+
+  public:
+    MZQTDLL_API CachedSpectrum();
+
+    //! \brief index of the first peak with m/z >= mz
+    MZQTDLL_API size_t lowerBound(double mz) const;
+
+    //! \brief index of the most intense peak in [lowMZ, highMZ], -1 if none
+    MZQTDLL_API long mostIntensePeak(double lowMZ, double highMZ) const;
+
+    //! \brief sum of the intensities in [lowMZ, highMZ]
+    MZQTDLL_API double sumIntensity(double lowMZ, double highMZ) const;
+
+    size_t size() const
+    {
+      return mz_.size();
+    }
+
+    long scanNumber_;
+    double retentionTimeInSec_;
+    std::vector<double> mz_;
+    std::vector<double> intensity_;
+
+  private:
+    friend class SpectrumCache;
+    unsigned long lastUse_;
+  };
+
+  /*! Small least recently used cache of spectra keyed by scan number.
+   *
+   * Used to keep the last MS1 scans around so that MSn scans can look at
+   * their parent without fetching it again from the vendor library.
+   */
+  class SpectrumCache {
+
+  public:
+    MZQTDLL_API explicit SpectrumCache(size_t capacity = 8);
+
+    MZQTDLL_API void setCapacity(size_t capacity);
+    MZQTDLL_API size_t capacity() const;
+    MZQTDLL_API void clear();
+
+    //! \brief copy the spectrum of scan in the cache, reusing the buffers of
+    //! the least recently used entry
+    MZQTDLL_API const CachedSpectrum *insert(const Scan &scan);
+    MZQTDLL_API const CachedSpectrum *insert(long scanNumber,
+        double retentionTimeInSec, const double *mz, const double *intensity,
+        size_t size);
+
+    //! \brief cached spectrum of scanNumber, NULL if not cached
+    MZQTDLL_API const CachedSpectrum *find(long scanNumber);
+
+    //! \brief cached spectrum with the highest scan number lower than
+    //! scanNumber, NULL if none
+    MZQTDLL_API const CachedSpectrum *findPrevious(long scanNumber);
+
+  private:
+    CachedSpectrum *slotForInsert(long scanNumber);
+    void touch(CachedSpectrum &entry);
+
+    std::vector<CachedSpectrum> entries_;
+    size_t capacity_;
+    unsigned long useCounter_;
+  };
+
+}
+
+#endif /* MZQT_SPECTRUMCACHE_H_ */
@@ -0,0 +1,105 @@
+/*
+ SpectrumValidator.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <limits>
+
+#include "SpectrumValidator.h"
+#include "Scan.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+SpectrumValidator::SpectrumValidator() :
+  validScans_(0), invalidScans_(0), massTolerance_(0.5), maxIntensity_(1.0e+15)
+{
+}
+
+void SpectrumValidator::setMassTolerance(double tolerance)
+{
+  massTolerance_ = tolerance;
+}
+
+void SpectrumValidator::setMaxIntensity(double intensity)
+{
+  maxIntensity_ = intensity;
+}
+
+template<typename T>
+int SpectrumValidator::check(const T *mz, const T *intensity, size_t size,
+    double lowMass, double highMass)
+{
+  if (size == 0)
+    return VALID;
+
+  T low = (T) (highMass > 0 ? lowMass - massTolerance_ : 0);
+  T high = highMass > 0 ? (T) (highMass + massTolerance_)
+      : std::numeric_limits<T>::max();
+  T maxIntensity = (T) maxIntensity_;
+
+  // one flag per test, or-ed over the peaks: no branch in the loop. x - x
+  // is not 0 for NaN and infinities
+  int unsorted = 0, notFinite = 0, outOfRange = 0, negative = 0,
+      tooHigh = 0, positive = 0;
+  T previous = mz[0];
+  for (size_t i = 0; i < size; ++i) {
+    T m = mz[i], v = intensity[i];
+    unsorted |= m < previous;
+    notFinite |= !(m - m == 0) | !(v - v == 0);
+    outOfRange |= (m <= 0) | (m < low) | (m > high);
+    negative |= v < 0;
+    tooHigh |= v > maxIntensity;
+    positive |= v > 0;
+    previous = m;
+  }
+
+  return (unsorted ? NOT_SORTED : 0) | (notFinite ? NOT_FINITE : 0)
+      | (outOfRange ? MASS_OUT_OF_RANGE : 0) | (negative ? NEGATIVE_INTENSITY
+      : 0) | (tooHigh ? INTENSITY_TOO_HIGH : 0) | (positive ? 0 : NO_INTENSITY);
+}
+
+int SpectrumValidator::validate(const float *mz, const float *intensity,
+    size_t size, double lowMass, double highMass)
+{
+  int result = check(mz, intensity, size, lowMass, highMass);
+  result == VALID ? validScans_++ : invalidScans_++;
+
+  return result;
+}
+
+int SpectrumValidator::validate(const double *mz, const double *intensity,
+    size_t size, double lowMass, double highMass)
+{
+  int result = check(mz, intensity, size, lowMass, highMass);
+  result == VALID ? validScans_++ : invalidScans_++;
+
+  return result;
+}
+
+int SpectrumValidator::validate(const Scan &scan)
+{
+  // the arrays of a header-only scan exist after this call
+  int size = scan.getNumDataPoints();
+  return validate(scan.mzArray_, scan.intensityArray_, size,
+                  scan.minObservedMZ_, scan.maxObservedMZ_);
+}
@@ -0,0 +1,99 @@
+/*
+ SpectrumValidator.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_SPECTRUMVALIDATOR_H_
+#define MZQT_SPECTRUMVALIDATOR_H_
+
+#include <cstddef>
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+namespace mzqt {
+
+  class Scan;
+
+  /*! Check the content of a spectrum read from a vendor library.
+   *
+   * Some files (Waters Xevo G2-S) contain uninitialized scans which get
+   * through the checks on the scan statistics. The peaks are tested in a
+   * single pass: m/z sorted and positive, values finite, masses inside the
+   * range of the scan statistics, intensities not negative, not too high
+   * and not all zero. The loop accumulates error bits instead of branching
+   * so that it can be vectorized.
+   */
+  class SpectrumValidator {
+
+  public:
+    //! bits returned by validate()
+    enum Error {
+      VALID = 0,
+      NOT_SORTED = 1,
+      NOT_FINITE = 2,
+      MASS_OUT_OF_RANGE = 4,
+      NEGATIVE_INTENSITY = 8,
+      INTENSITY_TOO_HIGH = 16,
+      NO_INTENSITY = 32
+    };
+
+    MZQTDLL_API SpectrumValidator();
+
+    //! \brief margin allowed around the low and high masses, in m/z
+    MZQTDLL_API void setMassTolerance(double tolerance);
+    MZQTDLL_API void setMaxIntensity(double intensity);
+
+    //! \brief check the peaks against the low and high masses of the scan
+    //! statistics (ignored if highMass <= 0), returns a combination of Error
+    //! bits, VALID if the spectrum is correct
+    MZQTDLL_API int validate(const float *mz, const float *intensity,
+        size_t size, double lowMass, double highMass);
+    MZQTDLL_API int validate(const double *mz, const double *intensity,
+        size_t size, double lowMass, double highMass);
+    MZQTDLL_API int validate(const Scan &scan);
+
+    long validScans_;
+    long invalidScans_;
+
+  private:
+    template<typename T>
+    int check(const T *mz, const T *intensity, size_t size, double lowMass,
+              double highMass);
+
+    double massTolerance_;
+    double maxIntensity_;
+  };
+
+}
+
+#endif /* MZQT_SPECTRUMVALIDATOR_H_ */
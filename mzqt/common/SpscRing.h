@@ -0,0 +1,128 @@
+/*
+ SpscRing.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_SPSCRING_H_
+#define MZQT_SPSCRING_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace mzqt {
+
+  /*! Bounded lock-free queue between exactly one producer thread and one
+   * consumer thread.
+   *
+   * The producer only writes tail_ and the consumer only writes head_, so
+   * no lock nor compare-and-swap is needed. Each side keeps a copy of the
+   * other index and reloads it only when the ring looks full or empty.
+   * Neither push() nor pop() wait: the caller decides how to.
+   */
+  template<typename T>
+  class SpscRing {
+
+  public:
+    //! \brief capacity is rounded up to a power of two
+    explicit SpscRing(size_t capacity = 16) :
+      head_(0), tail_(0), cachedHead_(0), cachedTail_(0)
+    {
+      size_t size = 2;
+      while (size < capacity)
+        size <<= 1;
+      buffer_.resize(size);
+      mask_ = size - 1;
+    }
+
+    size_t capacity() const
+    {
+      return buffer_.size();
+    }
+
+    //! \brief producer side, false if the ring is full
+    bool push(const T &value)
+    {
+      size_t tail = tail_.load(std::memory_order_relaxed);
+      if (tail - cachedHead_ == buffer_.size()) {
+        cachedHead_ = head_.load(std::memory_order_acquire);
+        if (tail - cachedHead_ == buffer_.size())
+          return false;
+      }
+      buffer_[tail & mask_] = value;
+      tail_.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    //! \brief consumer side, false if the ring is empty
+    bool pop(T &value)
+    {
+      size_t head = head_.load(std::memory_order_relaxed);
+      if (head == cachedTail_) {
+        cachedTail_ = tail_.load(std::memory_order_acquire);
+        if (head == cachedTail_)
+          return false;
+      }
+      value = buffer_[head & mask_];
+      head_.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+    //! \brief approximate when called while the other side is running
+    size_t size() const
+    {
+      return tail_.load(std::memory_order_acquire) - head_.load(
+          std::memory_order_acquire);
+    }
+
+    bool empty() const
+    {
+      return size() == 0;
+    }
+
+  private:
+    SpscRing(const SpscRing &); // intentionally undefined
+    SpscRing &operator=(const SpscRing &); // intentionally undefined
+
+    std::vector<T> buffer_;
+    size_t mask_;
+
+    // each index on its own cache line
+    alignas(64) std::atomic<size_t> head_; //!< written by the consumer
+    alignas(64) std::atomic<size_t> tail_; //!< written by the producer
+    alignas(64) size_t cachedHead_; //!< producer copy of head_
+    alignas(64) size_t cachedTail_; //!< consumer copy of tail_
+  };
+
+  //! \brief wait of the spins-th failed push() or pop() of a ring: spin a
+  //! little, then give the core away. A vendor call takes far longer than
+  //! a context switch
+  inline void backoff(int spins)
+  {
+    if (spins < 64)
+      std::this_thread::yield();
+    else
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+
+}
+
+#endif /* MZQT_SPSCRING_H_ */
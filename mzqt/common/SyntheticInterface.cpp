@@ -0,0 +1,329 @@
+/*
+ SyntheticInterface.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <algorithm>
+
+#include "SyntheticInterface.h"
+#include "Scan.h"
+#include "Debug.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+namespace {
+
+  const double MS1_START_MZ = 300.0;
+  const double MS1_END_MZ = 1500.0;
+  const double MSN_START_MZ = 100.0;
+
+  //! cheap deterministic hash in [0, 1)
+  double noise(long a, long b)
+  {
+    unsigned long h = (unsigned long) a * 2654435761UL ^ (unsigned long) b
+        * 40503UL;
+    h ^= h >> 13;
+    h *= 0x5bd1e995UL;
+    h ^= h >> 15;
+    return (h % 10007) / 10007.0;
+  }
+
+}
+
+SyntheticInterface::SyntheticInterface(void) :
+  numScans_(1000), initialScans_(1000), scansPerStep_(0), stepMs_(0),
+      numPeaks_(200), msnPerCycle_(5), scanTimeInSec_(0.2), firstTime_(true)
+{
+  instrumentInfo_.ionSource_ = ESI;
+  instrumentInfo_.analyzerList_.push_back(FTMS);
+  instrumentInfo_.detector_ = DETECTOR_UNDEF;
+  chargeCounts_.resize(1, 0);
+}
+
+SyntheticInterface::~SyntheticInterface(void)
+{
+}
+
+void SyntheticInterface::setNumScans(long numScans)
+{
+  numScans_ = initialScans_ = numScans;
+  scansPerStep_ = stepMs_ = 0;
+}
+
+void SyntheticInterface::setGrowth(long numScans, long scansPerStep,
+                                   long stepMs)
+{
+  initialScans_ = std::min(numScans, numScans_);
+  scansPerStep_ = scansPerStep;
+  stepMs_ = stepMs;
+}
+
+void SyntheticInterface::setNumPeaks(int numPeaks)
+{
+  numPeaks_ = std::max(numPeaks, 1);
+}
+
+void SyntheticInterface::setMSnPerCycle(int msnPerCycle)
+{
+  msnPerCycle_ = std::max(msnPerCycle, 0);
+}
+
+void SyntheticInterface::setScanTime(double scanTimeInSec)
+{
+  scanTimeInSec_ = scanTimeInSec;
+}
+
+void SyntheticInterface::initInterface(void)
+{
+}
+
+bool SyntheticInterface::setInputFile(const QString& fileName)
+{
+  detachPeakLoaders();
+  inputFileName_ = fileName;
+  openTime_ = Clock::now();
+
+  firstScanNumber_ = 1;
+  lastScanNumber_ = availableScans();
+  totalNumScans_ = lastScanNumber_;
+  curScanNum_ = firstScanNumber_;
+  firstTime_ = true;
+
+  startTimeInSec_ = 0;
+  endTimeInSec_ = (numScans_ - 1) * scanTimeInSec_;
+
+  Debug::dbg(Debug::MEDIUM) << "synthetic run " << inputFileName_ << ": "
+      << lastScanNumber_ << " of " << numScans_ << " scans written"
+      << Debug::ENDL;
+
+  return true;
+}
+
+void SyntheticInterface::setCentroiding(bool centroid)
+{
+  doCentroid_ = centroid;
+}
+
+void SyntheticInterface::setDeisotoping(bool deisotope)
+{
+  doDeisotope_ = deisotope;
+}
+
+void SyntheticInterface::setCompression(bool compression)
+{
+  doCompression_ = compression;
+}
+
+void SyntheticInterface::setShotgunFragmentation(bool sf)
+{
+  shotgunFragmentation_ = sf;
+}
+
+void SyntheticInterface::setLockspray(bool ls)
+{
+  lockspray_ = ls;
+}
+
+void SyntheticInterface::setVerbose(bool verbose)
+{
+  verbose_ = verbose;
+}
+
+long SyntheticInterface::availableScans(void) const
+{
+  if (scansPerStep_ <= 0 || stepMs_ <= 0)
+    return numScans_;
+
+  long elapsedMs = (long) std::chrono::duration_cast<
+      std::chrono::milliseconds>(Clock::now() - openTime_).count();
+  return std::min(numScans_, initialScans_ + (elapsedMs / stepMs_)
+      * scansPerStep_);
+}
+
+bool SyntheticInterface::inAcquisition(void)
+{
+  return availableScans() < numScans_;
+}
+
+bool SyntheticInterface::refreshScanCount(void)
+{
+  long available = availableScans();
+  if (available <= lastScanNumber_)
+    return false;
+
+  lastScanNumber_ = available;
+  totalNumScans_ = available;
+  return true;
+}
+
+Scan* SyntheticInterface::getScan(void)
+{
+  for (;;) {
+    if (!firstTime_)
+      ++curScanNum_;
+    else {
+      firstTime_ = false;
+      progress_.start(PROGRESS_READING, lastScanNumber_ - curScanNum_ + 1);
+    }
+
+    if (curScanNum_ > lastScanNumber_) {
+      // stay on the last scan: getScan() goes on after refreshScanCount()
+      curScanNum_ = lastScanNumber_;
+      progress_.finish();
+      return NULL;
+    }
+    progress_.advance();
+
+    Scan* scan = readScan(curScanNum_);
+    if (selection_.isEmpty())
+      return scan;
+
+    if (selection_.accepts(*scan)) {
+      selection_.trimPeaks(*scan);
+      return scan;
+    }
+    delete scan;
+  }
+}
+
+Scan* SyntheticInterface::getScan(long scanNumber)
+{
+  if (scanNumber < firstScanNumber_ || scanNumber > lastScanNumber_)
+    return NULL;
+
+  return readScan(scanNumber);
+}
+
+bool SyntheticInterface::seek(long scanNumber)
+{
+  if (scanNumber < firstScanNumber_ || scanNumber > lastScanNumber_)
+    return false;
+
+  curScanNum_ = scanNumber;
+  firstTime_ = true;
+
+  return true;
+}
+
+double SyntheticInterface::peakMZ(long scanNumber, int peak) const
+{
+  // sorted peaks: each one stays in its own slot of the scan range
+  double step = (MS1_END_MZ - MS1_START_MZ) / numPeaks_;
+  return MS1_START_MZ + step * (peak + 0.5 * noise(scanNumber, peak));
+}
+
+double SyntheticInterface::peakIntensity(long scanNumber, int peak) const
+{
+  return 1.0e3 + 1.0e6 * noise(peak, scanNumber);
+}
+
+Scan* SyntheticInterface::readScan(long scanNumber)
+{
+  Scan* scan = new Scan();
+
+  long cycle = msnPerCycle_ + 1;
+  long position = (scanNumber - 1) % cycle;
+
+  scan->scanNumber_ = scanNumber;
+  scan->msLevel_ = position == 0 ? 1 : 2;
+  scan->retentionTimeInSec_ = (scanNumber - 1) * scanTimeInSec_;
+  scan->polarity_ = POSITIVE;
+  scan->analyzer_ = FTMS;
+  scan->ionization_ = ESI;
+  scan->scanType_ = FULL;
+  scan->isCentroided_ = true;
+
+  if (scan->msLevel_ == 1) {
+    scan->startMZ_ = MS1_START_MZ;
+    scan->endMZ_ = MS1_END_MZ;
+  }
+  else {
+    // one precursor per MS1 peak slot, spread over the scan range
+    long parent = scanNumber - position;
+    int peak = (int) ((position * 7919L) % numPeaks_);
+    scan->activation_ = CID;
+    scan->precursorScanNumber_ = parent;
+    scan->precursorScanMSLevel_ = 1;
+    scan->precursorMZ_ = peakMZ(parent, peak);
+    scan->precursorIntensity_ = peakIntensity(parent, peak);
+    scan->precursorCharge_ = 2;
+    scan->collisionEnergy_ = 30.0;
+    scan->isolationWindow_ = 1.0;
+    scan->startMZ_ = MSN_START_MZ;
+    scan->endMZ_ = scan->precursorMZ_ * scan->precursorCharge_;
+  }
+
+  if (headerOnly_) {
+    // peaks are computed on first access
+    scan->setPeakLoader(peakLoader([this](Scan &s) {
+      readPeaks(s);
+    }));
+  }
+  else
+    readPeaks(*scan);
+
+  return scan;
+}
+
+void SyntheticInterface::readPeaks(Scan &scan)
+{
+  scan.setNumDataPoints(numPeaks_);
+
+  double start = scan.startMZ_;
+  double step = (scan.endMZ_ - scan.startMZ_) / numPeaks_;
+  scan.totalIonCurrent_ = 0;
+  scan.basePeakIntensity_ = 0;
+  for (int i = 0; i < numPeaks_; ++i) {
+    double mz = scan.msLevel_ == 1 ? peakMZ(scan.scanNumber_, i) : start
+        + step * (i + 0.5 * noise(scan.scanNumber_, i));
+    double intensity = peakIntensity(scan.scanNumber_, i);
+    scan.mzArray_[i] = mz;
+    scan.intensityArray_[i] = intensity;
+    scan.totalIonCurrent_ += intensity;
+    if (intensity > scan.basePeakIntensity_) {
+      scan.basePeakMZ_ = mz;
+      scan.basePeakIntensity_ = intensity;
+    }
+  }
+
+  scan.minObservedMZ_ = scan.mzArray_[0];
+  scan.maxObservedMZ_ = scan.mzArray_[numPeaks_ - 1];
+  progress_.addBytes(numPeaks_ * 2 * sizeof(double));
+
+  checkScanContent(scan);
+}
+
+QString SyntheticPlugin::name() const
+{
+  return "synthetic";
+}
+
+bool SyntheticPlugin::canRead(const QString &fileName) const
+{
+  return fileName.startsWith("synthetic:");
+}
+
+InstrumentInterface *SyntheticPlugin::create()
+{
+  return new SyntheticInterface();
+}
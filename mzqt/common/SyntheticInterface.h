@@ -0,0 +1,112 @@
+/*
+ SyntheticInterface.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_SYNTHETICINTERFACE_H_
+#define MZQT_SYNTHETICINTERFACE_H_
+
+#include <chrono>
+
+#include "InstrumentInterface.h"
+#include "InstrumentInterfacePlugin.h"
+
+namespace mzqt {
+
+  /*! In-process backend generating the scans of a DDA run: one MS1 scan
+   * followed by msnPerCycle MS2 scans of its most intense peaks, every
+   * scanTime seconds. The peaks only depend on the scan number.
+   *
+   * With setGrowth() the run is still in acquisition when the "file" is
+   * opened: scans appear over time like in a file written by an
+   * instrument, which is what TailFollowReader is tested with. No vendor
+   * library is needed.
+   *
+   * Built apart from the library, for the tests and mzqtworker: they add a
+   * SyntheticPlugin to their BackendRegistry.
+   */
+  class SyntheticInterface: public InstrumentInterface {
+
+  public:
+    SyntheticInterface(void);
+    ~SyntheticInterface(void);
+
+    //! \brief total number of scans of the run, taken into account by
+    //! setInputFile()
+    void setNumScans(long numScans);
+    //! \brief numScans are available at setInputFile(), then
+    //! scansPerStep more every stepMs milliseconds until the total is
+    //! reached. The acquisition ends there
+    void setGrowth(long numScans, long scansPerStep, long stepMs);
+    void setNumPeaks(int numPeaks);
+    void setMSnPerCycle(int msnPerCycle);
+    void setScanTime(double scanTimeInSec);
+
+    virtual void initInterface(void);
+    //! \brief the name is only kept for the logs
+    virtual bool setInputFile(const QString& fileName);
+    virtual void setCentroiding(bool centroid);
+    virtual void setDeisotoping(bool deisotope);
+    virtual void setCompression(bool compression);
+    virtual void setShotgunFragmentation(bool sf);
+    virtual void setLockspray(bool ls);
+    virtual void setVerbose(bool verbose);
+
+    virtual Scan* getScan(void);
+    virtual Scan* getScan(long scanNumber);
+    virtual bool seek(long scanNumber);
+
+    virtual bool inAcquisition(void);
+    virtual bool refreshScanCount(void);
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    //! \brief number of scans written at this time
+    long availableScans(void) const;
+    Scan* readScan(long scanNumber);
+    void readPeaks(Scan &scan);
+    double peakMZ(long scanNumber, int peak) const;
+    double peakIntensity(long scanNumber, int peak) const;
+
+    QString inputFileName_;
+    long numScans_;
+    long initialScans_;
+    long scansPerStep_;
+    long stepMs_;
+    int numPeaks_;
+    int msnPerCycle_;
+    double scanTimeInSec_;
+
+    Clock::time_point openTime_;
+    bool firstTime_;
+  };
+
+  //! \brief backend of the "synthetic:<name>" files
+  class SyntheticPlugin: public InstrumentInterfacePlugin {
+
+  public:
+    virtual QString name() const;
+    virtual bool canRead(const QString &fileName) const;
+    virtual InstrumentInterface *create();
+  };
+
+}
+
+#endif /* MZQT_SYNTHETICINTERFACE_H_ */
@@ -0,0 +1,131 @@
+/*
+ TailFollowReader.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <algorithm>
+#include <thread>
+
+#include "TailFollowReader.h"
+#include "InstrumentInterface.h"
+#include "Progress.h"
+#include "Scan.h"
+#include "Debug.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+namespace {
+
+  //! longest sleep without looking at the cancellation token
+  const long CANCEL_CHECK_MS = 50;
+
+}
+
+TailFollowReader::TailFollowReader(InstrumentInterface &iface) :
+  polls_(0), emptyPolls_(0), iface_(iface), minPollMs_(100),
+      maxPollMs_(5000), timeoutMs_(0), token_(NULL), finished_(false),
+      timedOut_(false)
+{
+}
+
+void TailFollowReader::setPollInterval(long minPollMs, long maxPollMs)
+{
+  minPollMs_ = std::max(minPollMs, 1L);
+  maxPollMs_ = std::max(maxPollMs, minPollMs_);
+}
+
+void TailFollowReader::setTimeout(long ms)
+{
+  timeoutMs_ = ms;
+}
+
+void TailFollowReader::setCancellationToken(const CancellationToken *token)
+{
+  token_ = token;
+}
+
+bool TailFollowReader::timedOut(void) const
+{
+  return timedOut_;
+}
+
+void TailFollowReader::wait(long ms)
+{
+  while (ms > 0) {
+    if (token_ != NULL)
+      token_->check();
+    long step = std::min(ms, CANCEL_CHECK_MS);
+    std::this_thread::sleep_for(std::chrono::milliseconds(step));
+    ms -= step;
+  }
+  if (token_ != NULL)
+    token_->check();
+}
+
+Scan* TailFollowReader::getScan(void)
+{
+  timedOut_ = false;
+  long delay = minPollMs_;
+  Clock::time_point lastScanTime = Clock::now();
+
+  for (;;) {
+    if (token_ != NULL)
+      token_->check();
+
+    Scan* scan = iface_.getScan();
+    if (scan != NULL)
+      return scan;
+
+    if (finished_)
+      return NULL;
+
+    // the state is read before the refresh: scans written just before the
+    // end of the acquisition are not missed
+    bool acquiring = iface_.inAcquisition();
+    polls_++;
+    if (iface_.refreshScanCount()) {
+      Debug::dbg(Debug::HIGH) << "file grown to scan "
+          << iface_.lastScanNumber_ << Debug::ENDL;
+      delay = minPollMs_;
+      lastScanTime = Clock::now();
+      continue;
+    }
+    emptyPolls_++;
+
+    if (!acquiring) {
+      finished_ = true;
+      return NULL;
+    }
+
+    if (timeoutMs_ > 0 && Clock::now() - lastScanTime
+        >= std::chrono::milliseconds(timeoutMs_)) {
+      Debug::dbg(Debug::LOW) << "no scan written for " << timeoutMs_
+          << " ms, giving up" << Debug::ENDL;
+      timedOut_ = true;
+      return NULL;
+    }
+
+    wait(delay);
+    delay = std::min(delay * 2, maxPollMs_);
+  }
+}
@@ -0,0 +1,106 @@
+/*
+ TailFollowReader.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_TAILFOLLOWREADER_H_
+#define MZQT_TAILFOLLOWREADER_H_
+
+#include <chrono>
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+namespace mzqt {
+
+  class Scan;
+  class InstrumentInterface;
+  class CancellationToken;
+
+  /*! Read the scans of a file still being written by the instrument.
+   *
+   * getScan() returns the scans already written, then waits for the next
+   * ones: the interface is refreshed every minPollMs, the delay doubling
+   * up to maxPollMs as long as nothing new is written. NULL is returned
+   * once the acquisition is over and every scan has been read. Typical
+   * use, for real-time QC:
+   *
+   *   TailFollowReader reader(iface);
+   *   while ((scan = reader.getScan()) != NULL) {
+   *     ...
+   *     delete scan;
+   *   }
+   *
+   * The backend has to implement InstrumentInterface::inAcquisition() and
+   * refreshScanCount(), otherwise the reader stops at the end of the scans
+   * written when the file was opened.
+   */
+  class TailFollowReader {
+
+  public:
+    MZQTDLL_API explicit TailFollowReader(InstrumentInterface &iface);
+
+    MZQTDLL_API void setPollInterval(long minPollMs, long maxPollMs);
+    //! \brief give up when no scan is written for ms milliseconds while the
+    //! file is still in acquisition, 0 to wait forever
+    MZQTDLL_API void setTimeout(long ms);
+    //! \brief getScan() throws Abort, even while waiting, once token is
+    //! cancelled. Not owned
+    MZQTDLL_API void setCancellationToken(const CancellationToken *token);
+
+    //! \brief next scan, waiting for it if needed. NULL at the end of the
+    //! acquisition or on timeout
+    MZQTDLL_API Scan* getScan(void);
+
+    //! \brief true if the last getScan() gave up waiting
+    MZQTDLL_API bool timedOut(void) const;
+
+    long polls_; //!< refreshes of the interface
+    long emptyPolls_; //!< refreshes without new scans
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    void wait(long ms);
+
+    InstrumentInterface &iface_;
+    long minPollMs_;
+    long maxPollMs_;
+    long timeoutMs_;
+    const CancellationToken *token_;
+    bool finished_;
+    bool timedOut_;
+  };
+
+}
+
+#endif /* MZQT_TAILFOLLOWREADER_H_ */
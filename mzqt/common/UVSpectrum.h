@@ -23,7 +23,7 @@
 #define MZQT_UVSPECTRUM_H_
 
 #include <iostream>
-#include "UVSPoint.h"
+#include "UVSpoint.h"
 
 #if defined(__GNUC__) || defined(MZQT_STATIC)
 #ifndef MZQTDLL_API
@@ -756,11 +756,13 @@ bool FilterLine::parse(string filterLine)
     }
 
     // activation info
-    // if msLevel >=2 there should be mass@energy pairs for each level >= 2
+    // if msLevel >=2 there should be mass@energy pairs for each level >= 2,
+    // MSX has one more for each multiplexed precursor
     if (msLevel_ > 1) {
-        int expectedPairs = msx_ ? 2 : msLevel_ - 1;
+        int expectedPairs = msLevel_ - 1;
 
-        for (int i = 0; i < expectedPairs; ++i) {
+        for (int i = 0; i < expectedPairs
+                 || (msx_ && w.find('@', 0) != string::npos); ++i) {
             char c = w[0];
             int markerPos = w.find('@', 0);
             if ((markerPos == string::npos)) {
@@ -30,6 +30,22 @@
 
 #include "MSTypes.h"
 
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
 namespace mzqt {
 
     class FilterLine {
@@ -95,12 +111,12 @@ namespace mzqt {
         std::vector<double> transitionRangeMax_;
         bool msx_; //MSMS range mode
 
-        FilterLine();
-        ~FilterLine();
+        MZQTDLL_API FilterLine();
+        MZQTDLL_API ~FilterLine();
 
-        void print();
+        MZQTDLL_API void print();
 
-        bool parse(std::string filterLine);
+        MZQTDLL_API bool parse(std::string filterLine);
 
     };
 
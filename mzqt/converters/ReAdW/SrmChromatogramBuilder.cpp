@@ -0,0 +1,172 @@
+/*
+ SrmChromatogramBuilder.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <algorithm>
+
+#include "SrmChromatogramBuilder.h"
+#include "FilterLine.h"
+#include "Scan.h"
+#include "Debug.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+namespace {
+
+  bool lessByQ3(const SrmTransition &a, const SrmTransition &b)
+  {
+    return a.q3Min_ < b.q3Min_;
+  }
+
+}
+
+SrmChromatogramBuilder::SrmChromatogramBuilder() :
+  unassignedPoints_(0), expectedScans_(0), reservedPoints_(0)
+{
+}
+
+void SrmChromatogramBuilder::setExpectedScans(long scans)
+{
+  expectedScans_ = scans;
+}
+
+void SrmChromatogramBuilder::clear()
+{
+  filters_.clear();
+  transitions_.clear();
+  unassignedPoints_ = 0;
+  reservedPoints_ = 0;
+}
+
+const std::vector<SrmTransition> &SrmChromatogramBuilder::transitions() const
+{
+  return transitions_;
+}
+
+bool SrmChromatogramBuilder::isSrm(const QString &filterLine)
+{
+  return filter(filterLine).first >= 0;
+}
+
+SrmChromatogramBuilder::Filter &SrmChromatogramBuilder::filter(
+    const QString &filterLine)
+{
+  QHash<QString, Filter>::iterator it = filters_.find(filterLine);
+  if (it != filters_.end())
+    return it.value();
+
+  Filter result = { -1, 0, 0 };
+
+  FilterLine parsed;
+  if (parsed.parse(filterLine.toStdString()) && parsed.scanType_ == SRM
+      && !parsed.transitionRangeMin_.empty()) {
+
+    result.first = (int) transitions_.size();
+    result.count = (int) parsed.transitionRangeMin_.size();
+
+    double q1 = parsed.cidParentMass_.empty() ? -1
+        : parsed.cidParentMass_[parsed.cidParentMass_.size() - 1];
+    for (int i = 0; i < result.count; ++i) {
+      SrmTransition transition;
+      transition.filterLine_ = filterLine;
+      transition.q1_ = q1;
+      transition.q3Min_ = parsed.transitionRangeMin_[i];
+      transition.q3Max_ = parsed.transitionRangeMax_[i];
+      transition.times_.reserve(reservedPoints_);
+      transition.intensities_.reserve(reservedPoints_);
+      transitions_.push_back(transition);
+    }
+
+    // ranges of a filter line are searched by their lower bound
+    std::sort(transitions_.begin() + result.first, transitions_.end(),
+              lessByQ3);
+
+    Debug::dbg(Debug::MEDIUM) << "SRM filter line with " << result.count
+        << " transitions: " << filterLine << Debug::ENDL;
+  }
+
+  return filters_.insert(filterLine, result).value();
+}
+
+void SrmChromatogramBuilder::reserve()
+{
+  // one cycle contains every filter line once
+  reservedPoints_ = expectedScans_ / std::max(filters_.size(), 1) + 1;
+  for (size_t i = 0; i < transitions_.size(); ++i) {
+    transitions_[i].times_.reserve(reservedPoints_);
+    transitions_[i].intensities_.reserve(reservedPoints_);
+  }
+}
+
+bool SrmChromatogramBuilder::addScan(const QString &filterLine,
+    double retentionTimeInSec, const double *mz, const double *intensity,
+    size_t size)
+{
+  Filter &f = filter(filterLine);
+  if (f.first < 0)
+    return false;
+
+  if (f.scans++ == 1 && reservedPoints_ == 0 && expectedScans_ > 0)
+    reserve();
+
+  SrmTransition *begin = &transitions_[f.first];
+  SrmTransition *end = begin + f.count;
+
+  sums_.assign(f.count, 0.0);
+  for (size_t i = 0; i < size; ++i) {
+    // last range starting at or below mz
+    SrmTransition *it = begin;
+    for (int n = f.count; n > 0;) {
+      int half = n / 2;
+      if (it[half].q3Min_ <= mz[i]) {
+        it += half + 1;
+        n -= half + 1;
+      }
+      else {
+        n = half;
+      }
+    }
+
+    if (it == begin || mz[i] > (it - 1)->q3Max_) {
+      unassignedPoints_++;
+      continue;
+    }
+    sums_[it - 1 - begin] += intensity[i];
+  }
+
+  for (SrmTransition *t = begin; t != end; ++t) {
+    t->times_.push_back(retentionTimeInSec);
+    t->intensities_.push_back(sums_[t - begin]);
+  }
+
+  return true;
+}
+
+bool SrmChromatogramBuilder::addScan(const Scan &scan)
+{
+  // before taking the arrays, which it may load
+  int size = scan.getNumDataPoints();
+  return addScan(scan.thermoFilterLine_, scan.retentionTimeInSec_,
+                 scan.mzArray_, scan.intensityArray_, size);
+}
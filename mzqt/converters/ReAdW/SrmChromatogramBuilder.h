@@ -0,0 +1,118 @@
+/*
+ SrmChromatogramBuilder.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_SRMCHROMATOGRAMBUILDER_H_
+#define MZQT_SRMCHROMATOGRAMBUILDER_H_
+
+#include <vector>
+
+#include <QHash>
+#include <QString>
+
+#if defined(__GNUC__) || defined(MZQT_STATIC)
+#ifndef MZQTDLL_API
+#define MZQTDLL_API
+#endif
+#else
+#ifdef MZQTDLL_EXPORTS
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllexport)
+#endif
+#else
+#ifndef MZQTDLL_API
+#define MZQTDLL_API __declspec(dllimport)
+#endif
+#endif
+#endif
+
+namespace mzqt {
+
+  class Scan;
+
+  /*! Chromatogram of one SRM transition: precursor (Q1) and product (Q3)
+   * mass range of a filter line
+   */
+  struct SrmTransition {
+    QString filterLine_;
+    double q1_;
+    double q3Min_;
+    double q3Max_;
+    std::vector<double> times_; //!< seconds
+    std::vector<double> intensities_;
+  };
+
+  /*! Build the chromatogram of each SRM transition in a single pass over the
+   * scans.
+   *
+   * Each filter line is parsed once, the first time it is seen. The data
+   * points of a SRM scan are then routed by binary search to the Q3 ranges
+   * of its filter line: every transition gets one point per scan, 0 when the
+   * scan has no data in the range.
+   *
+   * When the number of scans is known, the time series are allocated once
+   * the first acquisition cycle has been seen (the first time a filter line
+   * comes back).
+   */
+  class SrmChromatogramBuilder {
+
+  public:
+    MZQTDLL_API SrmChromatogramBuilder();
+
+    //! \brief total number of scans of the run, used to size the series
+    MZQTDLL_API void setExpectedScans(long scans);
+    MZQTDLL_API void clear();
+
+    //! \brief true if filterLine is a SRM filter line
+    MZQTDLL_API bool isSrm(const QString &filterLine);
+
+    //! \brief add the data points of a scan, returns false if the scan is
+    //! not a SRM scan
+    MZQTDLL_API bool addScan(const QString &filterLine,
+        double retentionTimeInSec, const double *mz, const double *intensity,
+        size_t size);
+    MZQTDLL_API bool addScan(const Scan &scan);
+
+    MZQTDLL_API const std::vector<SrmTransition> &transitions() const;
+
+    long unassignedPoints_; //!< data points outside any Q3 range
+
+  private:
+
+    //! transitions of a filter line, first < 0 if not a SRM filter line
+    struct Filter {
+      int first;
+      int count;
+      long scans;
+    };
+
+    Filter &filter(const QString &filterLine);
+    void reserve();
+
+    QHash<QString, Filter> filters_;
+    std::vector<SrmTransition> transitions_;
+    std::vector<double> sums_; //!< intensity per transition of a scan
+    long expectedScans_;
+    size_t reservedPoints_; //!< per transition, 0 until the first cycle
+  };
+
+}
+
+#endif /* MZQT_SRMCHROMATOGRAMBUILDER_H_ */
@@ -26,6 +26,7 @@
 #include <iostream>
 #include <iomanip>
 #include <cassert>
+#include <algorithm>
 
 #include <QDebug>
 #include <QFile>
@@ -37,6 +38,9 @@
 #include "Scan.h"
 #include "UVScan.h"
 #include "MSUtilities.h"
+#include "ConversionCheckpoint.h"
+#include "ScanVisitor.h"
+#include "MzMatcher.h"
 #include "Debug.h"
 
 #ifdef USE_MMGR_MEMORY_CHECK
@@ -60,6 +64,20 @@ namespace {
     END_CONTROLLER_TYPE
   };
 
+  //! the wrapper returns contiguous vectors, given as they are
+  template<typename T>
+  Span<const T> peakSpan(const QVector<T> &peaks, std::vector<T> &/*buffer*/)
+  {
+    return Span<const T>(peaks.constData(), peaks.size());
+  }
+
+  template<typename T>
+  Span<const T> peakSpan(const QList<T> &peaks, std::vector<T> &buffer)
+  {
+    buffer.assign(peaks.begin(), peaks.end());
+    return Span<const T>(buffer.data(), buffer.size());
+  }
+
 }
 
 ThermoInterfaceException::ThermoInterfaceException(const std::string &msg) :
@@ -72,7 +90,8 @@ ThermoInterfaceException::~ThermoInterfaceException() throw ()
 {
 }
 
-ThermoInterface::ThermoInterface(void)
+ThermoInterface::ThermoInterface(void) :
+  parentCache_(4)
 {
   // InstrumentInterface members
   instrumentInfo_.manufacturer_ = THERMO;
@@ -85,6 +104,13 @@ ThermoInterface::ThermoInterface(void)
 
   firstTime_ = true;
   firstUVTime_ = true;
+  selectionEnded_ = false;
+  selectionDone_ = false;
+
+  lastNonDependentScanNum_ = -1;
+  lastHeaderScanNum_ = -1;
+  lastHeaderDependent_ = true;
+  precursorIntensityPending_ = false;
 
   getPreInfoCount_ = 0;
   filterLineCount_ = 0;
@@ -154,8 +180,13 @@ bool ThermoInterface::setInputFile(const QString& filename)
       "").arg(filename).toStdString());
 
   // open raw file
+  detachPeakLoaders();
   xrawfile2_.Open(filename);
 
+  parentCache_.clear();
+  lastNonDependentScanNum_ = -1;
+  lastHeaderScanNum_ = -1;
+
   if (verbose_)
     Debug::msg() << "(Thermo lib opened file: " << filename << ")";
 
@@ -219,6 +250,7 @@ bool ThermoInterface::setInputFile(const QString& filename)
       << firstScanNumber_ << " through " << lastScanNumber_ << Debug::ENDL;
 
   curScanNum_ = firstScanNumber_;
+  selectionDone_ = false;
 
   totalNumScans_ = (lastScanNumber_ - firstScanNumber_) + 1;
 
@@ -435,43 +467,279 @@ void ThermoInterface::setCompression(bool compression)
   doCompression_ = compression;
 }
 
-Scan* ThermoInterface::getScan(void)
+bool ThermoInterface::nextScanNumber()
 {
+  if (selectionDone_)
+    return false;
+
   if (!firstTime_) {
     ++curScanNum_;
     if (curScanNum_ > lastScanNumber_) {
-      // we're done
-      return NULL;
+      // we're done, unless refreshScanCount() finds new scans: stay on the
+      // last one
+      curScanNum_ = lastScanNumber_;
+      progress_.finish();
+      return false;
     }
   }
   else {
     firstTime_ = false;
+    progress_.start(PROGRESS_READING, lastScanNumber_ - curScanNum_ + 1);
+  }
+
+  // skipped scans are counted too: the selection may skip most of them
+  progress_.advance();
+  return true;
+}
+
+Scan* ThermoInterface::getScan(void)
+{
+  bool select = !selection_.isEmpty();
+
+  while (nextScanNumber()) {
+    selectionEnded_ = false;
+    Scan* curScan = readScan(curScanNum_, select);
+    if (curScan != NULL)
+      return curScan;
+
+    if (selectionEnded_) {
+      // past the time range: no need to look at the remaining scans, even
+      // the ones still being acquired
+      selectionDone_ = true;
+      progress_.finish();
+      return NULL;
+    }
   }
 
-  Debug::dbg(Debug::MEDIUM) << "getting scan: " << curScanNum_ << Debug::ENDL;
+  return NULL;
+}
+
+long ThermoInterface::visitScans(ScanVisitor &visitor)
+{
+  bool select = !selection_.isEmpty();
+  double minMZ = -1, maxMZ = -1;
+  if (select && selection_.hasMZRange()) {
+    minMZ = selection_.minMZ();
+    maxMZ = selection_.maxMZ();
+  }
+
+  // reused for all the scans
+  QHash<QString, FilterLine> filters;
+  ScanHeader header;
+  double_container masses, intensities;
+  std::vector<double> massBuffer, intensityBuffer;
+  long numScans = 0;
+
+  while (nextScanNumber()) {
+    // header fields only, on the stack: no peak arrays are allocated
+    Scan scan;
+    MSScanDataType scanData;
+    int_t numDataPoints;
+
+    selectionEnded_ = false;
+    if (!readHeader(scan, curScanNum_, select, &filters, scanData,
+                    numDataPoints)) {
+      if (selectionEnded_) {
+        selectionDone_ = true;
+        progress_.finish();
+        break;
+      }
+      continue;
+    }
+
+    scan.isCentroided_ = isCentroided(scan, scanData);
+    header.assign(scan);
+    numScans++;
+    if (!visitor.onHeader(header))
+      continue;
+
+    masses.clear();
+    intensities.clear();
+    if (numDataPoints != 0)
+      fetchPeaks(scan, curScanNum_, scanData, minMZ, maxMZ, masses,
+                 intensities);
+
+    Span<const double> mz = peakSpan(masses, massBuffer);
+    Span<const double> intensity = peakSpan(intensities, intensityBuffer);
+    if (isParentSpectrum(scan, maxMZ))
+      parentCache_.insert(curScanNum_, scan.retentionTimeInSec_, mz.data(),
+                          intensity.data(), mz.size());
+
+    visitor.onPeaks(mz, intensity);
+  }
+
+  return numScans;
+}
+
+bool ThermoInterface::inAcquisition(void)
+{
+  int_t inAcquisition = 0;
+  xrawfile2_.InAcquisition(inAcquisition);
+
+  return inAcquisition != 0;
+}
+
+bool ThermoInterface::refreshScanCount(void)
+{
+  xrawfile2_.RefreshViewOfFile();
+
+  setMSController();
+  int_t lastScanNumber = lastScanNumber_;
+  xrawfile2_.GetLastSpectrumNumber(lastScanNumber);
+  if (lastScanNumber <= lastScanNumber_)
+    return false;
+
+  Debug::dbg(Debug::MEDIUM) << "file now contains scan numbers "
+      << firstScanNumber_ << " through " << lastScanNumber << Debug::ENDL;
+
+  lastScanNumber_ = lastScanNumber;
+  totalNumScans_ = (lastScanNumber_ - firstScanNumber_) + 1;
+
+  double endTime;
+  xrawfile2_.GetEndTime(endTime);
+  endTimeInSec_ = 60.0 * endTime;
+
+  return true;
+}
+
+void ThermoInterface::saveState(ConversionCheckpoint &checkpoint) const
+{
+  InstrumentInterface::saveState(checkpoint);
+
+  // where the precursors came from, reported at the end of the conversion
+  checkpoint.setValue("thermo.getPreInfoCount", QString::number(
+      getPreInfoCount_));
+  checkpoint.setValue("thermo.filterLineCount", QString::number(
+      filterLineCount_));
+  checkpoint.setValue("thermo.oldAPICount", QString::number(oldAPICount_));
+}
+
+void ThermoInterface::restoreState(const ConversionCheckpoint &checkpoint)
+{
+  InstrumentInterface::restoreState(checkpoint);
+
+  getPreInfoCount_ = checkpoint.value("thermo.getPreInfoCount", "0").toInt();
+  filterLineCount_ = checkpoint.value("thermo.filterLineCount", "0").toInt();
+  oldAPICount_ = checkpoint.value("thermo.oldAPICount", "0").toInt();
+}
+
+Scan* ThermoInterface::getScan(long scanNumber)
+{
+  if (scanNumber < firstScanNumber_ || scanNumber > lastScanNumber_)
+    return NULL;
+
+  return readScan(scanNumber);
+}
+
+bool ThermoInterface::seek(long scanNumber)
+{
+  if (scanNumber < firstScanNumber_ || scanNumber > lastScanNumber_)
+    return false;
+
+  curScanNum_ = scanNumber;
+  firstTime_ = true;
+  selectionDone_ = false;
+
+  return true;
+}
+
+long ThermoInterface::getScans(long first, long last, std::vector<Scan*> &out)
+{
+  first = std::max(first, (long) firstScanNumber_);
+  last = std::min(last, (long) lastScanNumber_);
+  if (last < first)
+    return 0;
+
+  // the vendor library has no call for the headers of several scans: each
+  // scan still costs its own header and filter line calls, only the parsing
+  // of the filter lines is shared. A run has few distinct ones apart from
+  // the MSn precursors
+  QHash<QString, FilterLine> filters;
+
+  size_t size = out.size();
+  out.reserve(size + (last - first + 1));
+  for (long scanNumber = first; scanNumber <= last; ++scanNumber) {
+    progress_.checkCancelled();
+    out.push_back(readScan(scanNumber, false, &filters));
+  }
+
+  return (long) (out.size() - size);
+}
+
+Scan* ThermoInterface::readScan(long scanNumber, bool select,
+                                QHash<QString, FilterLine> *filters)
+{
+  Debug::dbg(Debug::MEDIUM) << "getting scan: " << scanNumber << Debug::ENDL;
 
   Scan* curScan = new Scan();
 
+  MSScanDataType scanData;
+  int_t numDataPoints;
+  if (!readHeader(*curScan, scanNumber, select, filters, scanData,
+                  numDataPoints)) {
+    delete curScan;
+    return NULL;
+  }
+
+  // peaks outside the m/z window are not read
+  double minMZ = -1, maxMZ = -1;
+  if (select && selection_.hasMZRange()) {
+    minMZ = selection_.minMZ();
+    maxMZ = selection_.maxMZ();
+  }
+
+  if (headerOnly_) {
+    // peaks are read on first access, with the precursor intensity which
+    // needs the peaks of the parent
+    bool precursorIntensity = precursorIntensityPending_;
+    curScan->setPeakLoader(peakLoader([this, scanNumber, scanData,
+                                       numDataPoints, minMZ, maxMZ,
+                                       precursorIntensity](Scan &scan) {
+      readPeaks(&scan, scanNumber, scanData, numDataPoints, minMZ, maxMZ);
+      if (precursorIntensity)
+        readPrecursorIntensity(scan, scanNumber);
+    }));
+  }
+  else
+    readPeaks(curScan, scanNumber, scanData, numDataPoints, minMZ, maxMZ);
+
+  return curScan;
+}
+
+bool ThermoInterface::readHeader(Scan &scan, long scanNumber, bool select,
+                                 QHash<QString, FilterLine> *filters,
+                                 MSScanDataType &scanData,
+                                 int_t &numDataPoints)
+{
+  Scan* curScan = &scan;
+
   curScan->isThermo_ = true;
+  curScan->scanNumber_ = scanNumber;
 
   //// test the "scan event" call
   //// gives a more through scan filter line
   //BSTR bstrScanEvent = NULL;
-  //xrawfile2_->GetScanEventForScanNum(curScanNum_, &bstrScanEvent);
+  //xrawfile2_->GetScanEventForScanNum(scanNumber, &bstrScanEvent);
   //SysFreeString(bstrScanEvent);
 
   // Get the scan filter
   // (ex: "ITMS + c NSI Full ms [ 300.00-2000.00]")
   Debug::dbg(Debug::VERY_HIGH) << "getting filter line" << Debug::ENDL;
 
-  xrawfile2_.GetFilterForScanNum(curScanNum_, curScan->thermoFilterLine_);
+  xrawfile2_.GetFilterForScanNum(scanNumber, curScan->thermoFilterLine_);
 
   Debug::dbg(Debug::VERY_HIGH) << "parsing filter line" << Debug::ENDL;
 
   FilterLine filterLine;
-  if (!filterLine.parse(curScan->thermoFilterLine_.toStdString())) {
-    QString msg = "error parsing filter line: " + curScan->thermoFilterLine_;
-    throw ThermoInterfaceException(msg.toStdString());
+  if (filters != NULL && filters->contains(curScan->thermoFilterLine_))
+    filterLine = filters->value(curScan->thermoFilterLine_);
+  else {
+    if (!filterLine.parse(curScan->thermoFilterLine_.toStdString())) {
+      QString msg = "error parsing filter line: " + curScan->thermoFilterLine_;
+      throw ThermoInterfaceException(msg.toStdString());
+    }
+    if (filters != NULL)
+      filters->insert(curScan->thermoFilterLine_, filterLine);
   }
 
   // we should now have:
@@ -507,6 +775,14 @@ Scan* ThermoInterface::getScan(void)
   curScan->dependentActive_ = filterLine.dependentActive_
       == FilterLine::BOOL_TRUE ? true : false;
 
+  // parent of this scan for the "!d" filter of getPrecursorInfo()
+  if (scanNumber != lastHeaderScanNum_ + 1)
+    lastNonDependentScanNum_ = -1;
+  else if (!lastHeaderDependent_)
+    lastNonDependentScanNum_ = lastHeaderScanNum_;
+  lastHeaderScanNum_ = scanNumber;
+  lastHeaderDependent_ = curScan->dependentActive_;
+
   //r record in source fragmentation from filter line
   curScan->sourceCIDOn_ = filterLine.sourceCIDOn_
       == FilterLine::BOOL_TRUE ? true : false;
@@ -539,6 +815,15 @@ Scan* ThermoInterface::getScan(void)
         + filterLine.transitionRangeMax_[filterLine.transitionRangeMax_.size()
             - 1]) / 2;
   }
+
+  // the filter line is enough for most of the selection
+  if (select && (!selection_.acceptsMSLevel(curScan->msLevel_)
+      || !selection_.acceptsPolarity(curScan->polarity_)
+      || !selection_.acceptsFilter(curScan->thermoFilterLine_)
+      || !selection_.acceptsMZRange(curScan->startMZ_, curScan->endMZ_))) {
+    return false;
+  }
+
   // get additional header information through Xcalibur:
   // retention time
   // min/max observed mz
@@ -548,13 +833,13 @@ Scan* ThermoInterface::getScan(void)
 
   Debug::dbg(Debug::VERY_HIGH) << "getting scan header info" << Debug::ENDL;
 
-  int_t numDataPoints = -1; // points in both the m/z and intensity arrays
+  numDataPoints = -1; // points in both the m/z and intensity arrays
   double retentionTimeInMinutes = -1;
   int_t channel; // unused
   bool_t uniformTime; // unused
   double frequency; // unused
 
-  xrawfile2_.GetScanHeaderInfoForScanNum(curScanNum_, numDataPoints,
+  xrawfile2_.GetScanHeaderInfoForScanNum(scanNumber, numDataPoints,
                                          retentionTimeInMinutes,
                                          curScan->minObservedMZ_,
                                          curScan->maxObservedMZ_,
@@ -566,7 +851,7 @@ Scan* ThermoInterface::getScan(void)
   );
 
   //Good summary of what the scan is
-  Debug::dbg(Debug::LOW) << "getting scan: " << curScanNum_ << " time: "
+  Debug::dbg(Debug::LOW) << "getting scan: " << scanNumber << " time: "
       << retentionTimeInMinutes << " filter: " << curScan->thermoFilterLine_
       << Debug::ENDL;
 
@@ -576,20 +861,35 @@ Scan* ThermoInterface::getScan(void)
   // record the retention time
   curScan->retentionTimeInSec_ = retentionTimeInMinutes * 60.0;
 
+  if (select && !selection_.acceptsRetentionTime(curScan->retentionTimeInSec_)) {
+    selectionEnded_ = selection_.isPastRetentionTime(
+        curScan->retentionTimeInSec_);
+    return false;
+  }
+
   // if ms level 2 or above, get precursor info
+  precursorIntensityPending_ = false;
   if (curScan->msLevel_ > 1) {
 
     Debug::dbg(Debug::VERY_HIGH) << "getting precursor info" << Debug::ENDL;
 
-    getPrecursorInfo(*curScan, curScanNum_, filterLine);
+    getPrecursorInfo(*curScan, scanNumber, filterLine);
   }
 
+  scanData = filterLine.scanData_;
+  return true;
+}
+
+void ThermoInterface::readPeaks(Scan* curScan, long scanNumber,
+                                MSScanDataType scanData, int_t numDataPoints,
+                                double minMZ, double maxMZ)
+{
   //
   // get the m/z intensity pairs list for the current scan
   // !and correct min/max observed m/z info here!
   //
 
-  // Debug::dbg(Debug::VERY_HIGH) << "reading data points for scan " << curScanNum_ << endl;
+  // Debug::dbg(Debug::VERY_HIGH) << "reading data points for scan " << scanNumber << endl;
 
   curScan->minObservedMZ_ = 0;
   curScan->maxObservedMZ_ = 0;
@@ -599,84 +899,25 @@ Scan* ThermoInterface::getScan(void)
 
   if (numDataPoints != 0) {
 
-    // set up the parameters to read the scan
-    // TODO make centroid parameter user customizable
-    int dataPoints = 0;
-    int_t scanNum = curScanNum_;
-    QString szFilter = curScan->thermoFilterLine_;
-
-    // record centroiding info
-    //
-    // scan may have been centroided at accquision time,
-    // rather than conversion time (now)
-    // even if user didn't request it.
-    if (doCentroid_ || filterLine.scanData_ == CENTROID) {
-      curScan->isCentroided_ = true;
-    }
-
-    // Note: special case for FT centroiding, contributed from Matt Chambers
-    if (doCentroid_ && (curScan->analyzer_ == FTMS)) {
-      // use GetLabelData to workaround bug in Thermo centroiding of FT profile data
-
-      Debug::dbg(Debug::VERY_HIGH) << "using get label data" << Debug::ENDL;
-
-      double_container masses, intensities;
-
-      xrawfile2_.GetLabelData(masses, intensities, scanNum);
-
-      // record the number of data point (allocates memory for arrays)
+    double_container masses, intensities;
+    fetchPeaks(*curScan, scanNumber, scanData, minMZ, maxMZ, masses,
+               intensities);
 
-      Debug::dbg(Debug::VERY_HIGH) << "saving: " << masses.size()
-          << " data points" << Debug::ENDL;
+    Debug::dbg(Debug::VERY_HIGH) << "saving: " << masses.size()
+        << " data points" << Debug::ENDL;
 
-      assert(intensities.size() == masses.size());
-      dataPoints = masses.size();
-      curScan->setNumDataPoints(dataPoints);
-      for (long i = 0; i < dataPoints; ++i) {
-        curScan->mzArray_[i] = masses.at(i);
-        curScan->intensityArray_[i] = intensities.at(i);
-      }
+    // record the number of data point (allocates memory for arrays)
+    int dataPoints = masses.size();
+    curScan->setNumDataPoints(dataPoints);
+    // record mass list information in scan object
+    for (long j = 0; j < dataPoints; j++) {
+      curScan->mzArray_[j] = masses[j];
+      curScan->intensityArray_[j] = intensities[j];
     }
-    else {
 
-      Debug::dbg(Debug::VERY_HIGH) << "using average function" << Debug::ENDL;
-
-      // centroid is not done anyway because of thermo bug
-      if (curScan->isCentroided_ == true && filterLine.scanData_ == PROFILE)
-        curScan->isCentroided_ = false;
-
-      bool centroidThisScan = curScan->isCentroided_;
-
-      //work around
-      //call average function with only one scan since normal mass list call
-      //doesn't seem to always works
-      double_container masses, intensities;
-      int_container scanNumbers;
-      scanNumbers << scanNum;
-      xrawfile2_.GetAveragedMassSpectrum(scanNumbers, centroidThisScan, masses,
-                                         intensities);
-
-      Debug::dbg(Debug::VERY_HIGH) << "saving: " << intensities.size()
-          << " data points" << Debug::ENDL;
-
-      // record the number of data point (allocates memory for arrays)
-      assert(masses.size() == intensities.size());
-      dataPoints = masses.size();
-      curScan->setNumDataPoints(dataPoints);
-      // record mass list information in scan object
-      for (long j = 0; j < dataPoints; j++) {
-        curScan->mzArray_[j] = masses[j];
-        curScan->intensityArray_[j] = intensities[j];
-      }
-
-      /*
-       if (doCentroid_ && filterLine.scanData_ == PROFILE)
-       {
-       curScan->centroid(""); //TODO check if the algorithm works well
-       }
-       */
-
-    }
+    // the MSn scans of the cycle find their parent without reading it again
+    if (isParentSpectrum(*curScan, maxMZ))
+      parentCache_.insert(*curScan);
 
     // If we centroided the data we need to correct the basePeak m/z and intensity
     if (doCentroid_) {
@@ -704,20 +945,110 @@ Scan* ThermoInterface::getScan(void)
       curScan->maxObservedMZ_ = curScan->mzArray_[curScan->getNumDataPoints()
           - 1];
     }
+
+    checkScanContent(*curScan);
   } // end 'not empty scan'
 
   else {
     // if empty scan:
     if (verbose_) {
-      Debug::msg() << "Note: empty scan detected (scan # " << curScanNum_
+      Debug::msg() << "Note: empty scan detected (scan # " << scanNumber
           << ")" << endl;
     }
   }
 
-  return curScan;
 }
 
 // get precursor m/z, collision energy, precursor charge, and precursor intensity
+bool ThermoInterface::isCentroided(const Scan &scan,
+                                   MSScanDataType scanData) const
+{
+  // Note: special case for FT centroiding, contributed from Matt Chambers
+  if (doCentroid_ && scan.analyzer_ == FTMS)
+    return true;
+
+  // scan may have been centroided at accquision time,
+  // rather than conversion time (now)
+  // even if user didn't request it.
+  // centroid is not done anyway on profile data because of thermo bug
+  return (doCentroid_ || scanData == CENTROID) && scanData != PROFILE;
+}
+
+bool ThermoInterface::isParentSpectrum(const Scan &scan, double maxMZ) const
+{
+  // the parent is read with GetPrevMassListFromScanNum(), not centroided
+  return !scan.dependentActive_ && scan.msLevel_ == 1 && !doCentroid_
+      && maxMZ <= 0;
+}
+
+void ThermoInterface::fetchPeaks(Scan &scan, long scanNumber,
+                                 MSScanDataType scanData, double minMZ,
+                                 double maxMZ, double_container &masses,
+                                 double_container &intensities)
+{
+  int_t scanNum = scanNumber;
+
+  // record centroiding info
+  scan.isCentroided_ = isCentroided(scan, scanData);
+
+  // Note: special case for FT centroiding, contributed from Matt Chambers
+  if (doCentroid_ && (scan.analyzer_ == FTMS)) {
+    // use GetLabelData to workaround bug in Thermo centroiding of FT profile data
+
+    Debug::dbg(Debug::VERY_HIGH) << "using get label data" << Debug::ENDL;
+
+    xrawfile2_.GetLabelData(masses, intensities, scanNum);
+  }
+  else {
+
+    Debug::dbg(Debug::VERY_HIGH) << "using average function" << Debug::ENDL;
+
+    bool centroidThisScan = scan.isCentroided_;
+
+    if (maxMZ > 0) {
+      // only the peaks of the m/z window are transferred
+      double centroidPeakWidth = 0;
+      QString massRange = QString::number(minMZ, 'f', 4) + "-"
+          + QString::number(maxMZ, 'f', 4);
+      xrawfile2_.GetMassListRangeFromScanNum(scanNum, "", 0, 0, 0,
+                                             centroidThisScan,
+                                             centroidPeakWidth, massRange,
+                                             masses, intensities);
+    }
+    else {
+      //work around
+      //call average function with only one scan since normal mass list call
+      //doesn't seem to always works
+      int_container scanNumbers;
+      scanNumbers << scanNum;
+      xrawfile2_.GetAveragedMassSpectrum(scanNumbers, centroidThisScan,
+                                         masses, intensities);
+    }
+
+    /*
+     if (doCentroid_ && scanData == PROFILE)
+     {
+     scan.centroid(""); //TODO check if the algorithm works well
+     }
+     */
+  }
+
+  assert(masses.size() == intensities.size());
+  progress_.addBytes(masses.size() * 2 * sizeof(double));
+
+  if (maxMZ > 0) {
+    // the label data are not restricted to the m/z window
+    int first = std::lower_bound(masses.begin(), masses.end(), minMZ)
+        - masses.begin();
+    int last = std::upper_bound(masses.begin(), masses.end(), maxMZ)
+        - masses.begin();
+    masses.erase(masses.begin() + last, masses.end());
+    masses.erase(masses.begin(), masses.begin() + first);
+    intensities.erase(intensities.begin() + last, intensities.end());
+    intensities.erase(intensities.begin(), intensities.begin() + first);
+  }
+}
+
 void ThermoInterface::getPrecursorInfo(Scan& scan, long scanNumber,
     FilterLine& filterLine)
 {
@@ -876,7 +1207,7 @@ void ThermoInterface::getPrecursorInfo(Scan& scan, long scanNumber,
       Debug::dbg(Debug::VERY_HIGH) << "try to get mz extra value..."
           << Debug::ENDL;
       // ignore return value from this call
-      xrawfile2_.GetTrailerExtraValueForScanNum(curScanNum_,
+      xrawfile2_.GetTrailerExtraValueForScanNum(scanNumber,
                                                 "Monoisotopic M/Z:", varValue);
 
       precursorMZ = varValue.toDouble();
@@ -920,7 +1251,7 @@ void ThermoInterface::getPrecursorInfo(Scan& scan, long scanNumber,
       << Debug::ENDL;
 
   double collisionEnergy = 0;
-  xrawfile2_.GetTrailerExtraValueForScanNum(curScanNum_,
+  xrawfile2_.GetTrailerExtraValueForScanNum(scanNumber,
                                             "API Source CID Energy:", varValue);
 
   collisionEnergy = varValue.toDouble();
@@ -952,7 +1283,7 @@ void ThermoInterface::getPrecursorInfo(Scan& scan, long scanNumber,
 
     Debug::dbg(Debug::VERY_HIGH) << "try to get charge state extra value..."
         << Debug::ENDL;
-    xrawfile2_.GetTrailerExtraValueForScanNum(curScanNum_, "Charge State:",
+    xrawfile2_.GetTrailerExtraValueForScanNum(scanNumber, "Charge State:",
                                               varValue);
 
     trailerPrecursorCharge = varValue.toInt();
@@ -991,6 +1322,22 @@ void ThermoInterface::getPrecursorInfo(Scan& scan, long scanNumber,
     chargeCounts_[scan.precursorCharge_]++;
   }
 
+  // the parent is known without reading it when reading in order
+  if (lastNonDependentScanNum_ > 0)
+    scan.precursorScanNumber_ = lastNonDependentScanNum_;
+
+  // reading the parent peaks would defeat header-only reading: the
+  // intensity is read with the peaks of the scan
+  if (headerOnly_) {
+    precursorIntensityPending_ = true;
+    return;
+  }
+
+  readPrecursorIntensity(scan, scanNumber);
+}
+
+void ThermoInterface::readPrecursorIntensity(Scan& scan, long scanNumber)
+{
   //
   // precursor intensity determination
   //
@@ -1001,54 +1348,62 @@ void ThermoInterface::getPrecursorInfo(Scan& scan, long scanNumber,
 
   //if( numDataPoints != 0 ) { // if this isn't an empty scan
 
-  double_container masses, intensities;
+  // the parent is known when reading in order: the MSn scans after the
+  // first one of a cycle find it in the cache
+  const CachedSpectrum *parent = NULL;
+  if (scan.precursorScanNumber_ > 0)
+    parent = parentCache_.find(scan.precursorScanNumber_);
 
-  // set up the parameters to read the precursor scan
-  QString szFilter = "!d"; // First previous not-dependent scan
-  long intensityCutoffType = 0; // No cutoff
-  long intensityCutoffValue = 0; // No cutoff
-  long maxNumberOfPeaks = 0; // Return all data peaks
-  bool centroidResult = false; // No centroiding of the precursor
-  double centroidPeakWidth = 0; // (see above: no centroiding)
-
-  // Debug::dbg(Debug::VERY_HIGH) << "reading scan " << curScanNum_ << endl;
+  if (parent == NULL) {
+    double_container masses, intensities;
 
-  int_t curScanNum = scanNumber;
+    // set up the parameters to read the precursor scan
+    QString szFilter = "!d"; // First previous not-dependent scan
+    long intensityCutoffType = 0; // No cutoff
+    long intensityCutoffValue = 0; // No cutoff
+    long maxNumberOfPeaks = 0; // Return all data peaks
+    bool centroidResult = false; // No centroiding of the precursor
+    double centroidPeakWidth = 0; // (see above: no centroiding)
+
+    int_t curScanNum = scanNumber;
+
+    // the goal is to get the parent scan's info
+    xrawfile2_.GetPrevMassListFromScanNum(curScanNum, szFilter, // filter
+                                          intensityCutoffType, // intensityCutoffType
+                                          intensityCutoffValue, // intensityCutoffValue
+                                          maxNumberOfPeaks, // maxNumberOfPeaks
+                                          centroidResult, // centroidResult
+                                          centroidPeakWidth, // centroidingPeakWidth
+                                          masses, intensities);
 
-  // the goal is to get the parent scan's info
-  xrawfile2_.GetPrevMassListFromScanNum(curScanNum, szFilter, // filter
-                                        intensityCutoffType, // intensityCutoffType
-                                        intensityCutoffValue, // intensityCutoffValue
-                                        maxNumberOfPeaks, // maxNumberOfPeaks
-                                        centroidResult, // centroidResult
-                                        centroidPeakWidth, // centroidingPeakWidth
-                                        masses, intensities);
+    assert(masses.size() == intensities.size());
+    // double_container may be a QList: not contiguous
+    std::vector<double> mz(masses.begin(), masses.end());
+    std::vector<double> intensity(intensities.begin(), intensities.end());
+
+    // curScanNum set during last xrawfile2 call, the mass list is sorted by
+    // m/z
+    parent = parentCache_.insert(curScanNum, -1, mz.data(), intensity.data(),
+                                 mz.size());
+  }
 
   // record the precursor scan number
-  scan.precursorScanNumber_ = curScanNum; // set during last xrawfile2 call
-
+  scan.precursorScanNumber_ = parent->scanNumber_;
 
   Debug::dbg(Debug::VERY_HIGH) << "precursor scan number: "
       << scan.precursorScanNumber_ << Debug::ENDL;
   Debug::dbg(Debug::VERY_HIGH) << "looking at precursor mass list for "
-      << masses.size() << " data points" << Debug::ENDL;
-
-  assert(masses.size() == intensities.size());
-  double precursorIntensity = 0;
-  for (int j = 0; j < masses.size(); ++j) {
-    double dMass = masses[j];
+      << (long) parent->size() << " data points" << Debug::ENDL;
 
-    if (fabs(scan.precursorMZ_ - dMass) < 0.05) {
-      if (intensities[j] > precursorIntensity) {
-        precursorIntensity = intensities[j];
-      }
-    }
-    // stop if we've gone too far
-    if (dMass - scan.precursorMZ_ > 0.05) {
-      break;
-    }
-  }
+  MzMatcher matcher;
+  matcher.setAbsoluteTolerance(0.05);
+  std::vector<long> peaks;
+  matcher.match(MzMatcher::Array<double>(&scan.precursorMZ_, 1), parent->mz_,
+                parent->intensity_, MzMatcher::MOST_INTENSE, peaks);
+  scan.precursorIntensity_ = peaks[0] >= 0 ? parent->intensity_[peaks[0]] : 0;
 
+  Debug::dbg(Debug::VERY_HIGH) << "precursor intensity: "
+      << scan.precursorIntensity_ << Debug::ENDL;
 }
 
 UVScan *ThermoInterface::getUVScan(void)
@@ -1123,3 +1478,50 @@ void ThermoInterface::getChromatogram(long chroTrace, QVector<double> &times,
 {
   xrawfile2_.GetChromatogram(chroTrace, times, intensities);
 }
+
+void ThermoInterface::buildSrmChromatograms(SrmChromatogramBuilder &builder)
+{
+  builder.setExpectedScans(totalNumScans_);
+
+  QString filter;
+  int_t numDataPoints;
+  double retentionTimeInMinutes, lowMass, highMass, tic, basePeakMZ,
+      basePeakIntensity, frequency;
+  int_t channel;
+  bool_t uniformTime;
+  double_container masses, intensities;
+  int_container scanNumbers;
+  std::vector<double> mz, intensity;
+
+  // the current scan of getScan() is left untouched
+  for (long scanNum = firstScanNumber_; scanNum <= lastScanNumber_; ++scanNum) {
+
+    progress_.checkCancelled();
+    xrawfile2_.GetFilterForScanNum(scanNum, filter);
+    if (!builder.isSrm(filter))
+      continue;
+
+    xrawfile2_.GetScanHeaderInfoForScanNum(scanNum, numDataPoints,
+                                           retentionTimeInMinutes, lowMass,
+                                           highMass, tic, basePeakMZ,
+                                           basePeakIntensity, channel,
+                                           uniformTime, frequency);
+
+    // same call as getScan(), containers are reused between scans
+    masses.clear();
+    intensities.clear();
+    scanNumbers.clear();
+    scanNumbers << scanNum;
+    xrawfile2_.GetAveragedMassSpectrum(scanNumbers, false, masses, intensities);
+
+    assert(masses.size() == intensities.size());
+    mz.assign(masses.begin(), masses.end());
+    intensity.assign(intensities.begin(), intensities.end());
+
+    builder.addScan(filter, retentionTimeInMinutes * 60.0, mz.data(),
+                    intensity.data(), mz.size());
+  }
+
+  Debug::dbg(Debug::MEDIUM) << "built " << builder.transitions().size()
+      << " SRM chromatograms" << Debug::ENDL;
+}
@@ -27,25 +27,33 @@
 
 #include <string>
 
+#include <QHash>
+
 #include "Exception.h"
 #include "InstrumentInterface.h"
 #include "FilterLine.h"
+#include "SrmChromatogramBuilder.h"
+#include "SpectrumCache.h"
 #ifdef MZQT_XRAWFILE_WRAPPER
 #include "xrawfilewrapper.h"
 #else
 #include "XRawfile.h"
 #endif
 
-#ifdef __GNUC__
-#define MZQTDLL_API
+// part of mzqt.dll in the monolithic build, private to the backend plugin
+// otherwise
+#if defined(__GNUC__) || defined(MZQT_STATIC) || defined(MZQT_BACKEND_PLUGIN)
+#ifndef MZQTBACKEND_API
+#define MZQTBACKEND_API
+#endif
 #else
 #ifdef MZQTDLL_EXPORTS
-#ifndef MZQTDLL_API
-#define MZQTDLL_API __declspec(dllexport)
+#ifndef MZQTBACKEND_API
+#define MZQTBACKEND_API __declspec(dllexport)
 #endif
 #else
-#ifndef MZQTDLL_API
-#define MZQTDLL_API __declspec(dllimport)
+#ifndef MZQTBACKEND_API
+#define MZQTBACKEND_API __declspec(dllimport)
 #endif
 #endif
 #endif
@@ -60,8 +68,8 @@ namespace mzqt {
   class ThermoInterfaceException: public Exception {
 
   public:
-    MZQTDLL_API explicit ThermoInterfaceException(const std::string &msg = "");
-    MZQTDLL_API virtual ~ThermoInterfaceException() throw ();
+    MZQTBACKEND_API explicit ThermoInterfaceException(const std::string &msg = "");
+    MZQTBACKEND_API virtual ~ThermoInterfaceException() throw ();
   };
 
 
@@ -80,9 +88,47 @@ namespace mzqt {
     bool firstTime_;
     bool firstUVTime_;
 
+    bool nextScanNumber();
+    //! \brief false if select is true and the scan is not in selection_
+    bool readHeader(Scan &scan, long scanNumber, bool select,
+                    QHash<QString, FilterLine> *filters,
+                    MSScanDataType &scanData, int_t &numDataPoints);
+    bool isCentroided(const Scan &scan, MSScanDataType scanData) const;
+    void fetchPeaks(Scan &scan, long scanNumber, MSScanDataType scanData,
+                    double minMZ, double maxMZ, double_container &masses,
+                    double_container &intensities);
+    //! \brief NULL if select is true and the scan is not in selection_.
+    //! Parsed filter lines are looked up in and added to filters if given
+    Scan* readScan(long scanNumber, bool select = false,
+                   QHash<QString, FilterLine> *filters = NULL);
+    void readPeaks(Scan* curScan, long scanNumber, MSScanDataType scanData,
+                   int_t numDataPoints, double minMZ, double maxMZ);
+    bool selectionEnded_; // set by readScan() past the selected time range
+    // getScan() or visitScans() went past the selected time range: the
+    // scans found later by refreshScanCount() are not read. Reset by seek()
+    bool selectionDone_;
     void getPrecursorInfo(Scan& scan, long scanNumber, FilterLine& filterLine);
+    //! \brief from the peaks of the parent of scan, Scan::precursorScanNumber_
+    //! if known or the previous not-dependent scan
+    void readPrecursorIntensity(Scan& scan, long scanNumber);
+    //! \brief true if the peaks read for scan are the ones
+    //! readPrecursorIntensity() fetches for a parent: a not-dependent scan
+    //! read in full, as acquired
+    bool isParentSpectrum(const Scan &scan, double maxMZ) const;
+    // set by getPrecursorInfo() in header-only mode: the precursor intensity
+    // is read with the peaks of the scan
+    bool precursorIntensityPending_;
     bool forcePrecursorFromFilter_;
 
+    // parent MS1 spectra fetched for the precursor intensity: the MSn scans
+    // of a cycle share their parent
+    SpectrumCache parentCache_;
+    // first not-dependent scan before the header being read, -1 if unknown
+    // because the previous header was not the previous scan
+    long lastNonDependentScanNum_;
+    long lastHeaderScanNum_;
+    bool lastHeaderDependent_;
+
   public:
     int getPreInfoCount_;
     int filterLineCount_;
@@ -90,33 +136,48 @@ namespace mzqt {
 
 
   public:
-    MZQTDLL_API ThermoInterface(void);
-    MZQTDLL_API ~ThermoInterface(void);
-
-    MZQTDLL_API virtual void initInterface(void);
-    MZQTDLL_API void initUVScan();
-
-    MZQTDLL_API void setMSController();
-    MZQTDLL_API void setUVController();
-    MZQTDLL_API void setAnalogController();
-
-    MZQTDLL_API virtual bool setInputFile(const QString& fileName);
-    MZQTDLL_API virtual void setCentroiding(bool centroid);
-    MZQTDLL_API virtual void setDeisotoping(bool deisotope);
-    MZQTDLL_API virtual void setCompression(bool compression);
-    MZQTDLL_API virtual void forcePrecursorFromFilter(bool mode);
-    MZQTDLL_API virtual void setVerbose(bool verbose);
-    MZQTDLL_API virtual void setShotgunFragmentation(bool /*sf*/)
+    MZQTBACKEND_API ThermoInterface(void);
+    MZQTBACKEND_API ~ThermoInterface(void);
+
+    MZQTBACKEND_API virtual void initInterface(void);
+    MZQTBACKEND_API void initUVScan();
+
+    MZQTBACKEND_API void setMSController();
+    MZQTBACKEND_API void setUVController();
+    MZQTBACKEND_API void setAnalogController();
+
+    MZQTBACKEND_API virtual bool setInputFile(const QString& fileName);
+    MZQTBACKEND_API virtual void setCentroiding(bool centroid);
+    MZQTBACKEND_API virtual void setDeisotoping(bool deisotope);
+    MZQTBACKEND_API virtual void setCompression(bool compression);
+    MZQTBACKEND_API virtual void forcePrecursorFromFilter(bool mode);
+    MZQTBACKEND_API virtual void setVerbose(bool verbose);
+    MZQTBACKEND_API virtual void setShotgunFragmentation(bool /*sf*/)
     {
     }
-    MZQTDLL_API virtual void setLockspray(bool /*ls*/)
+    MZQTBACKEND_API virtual void setLockspray(bool /*ls*/)
     {
     }
 
-    MZQTDLL_API virtual Scan* getScan(void);
-    MZQTDLL_API virtual UVScan* getUVScan(void);
-    MZQTDLL_API void getChromatogram(long chroTrace, QVector<double> &times,
+    MZQTBACKEND_API virtual Scan* getScan(void);
+    MZQTBACKEND_API virtual Scan* getScan(long scanNumber);
+    MZQTBACKEND_API virtual bool seek(long scanNumber);
+    //! \brief as getScan(scanNumber) for each scan, with a cache of the
+    //! parsed filter lines
+    MZQTBACKEND_API virtual long getScans(long first, long last,
+                                      std::vector<Scan*> &out);
+    MZQTBACKEND_API virtual long visitScans(ScanVisitor &visitor);
+    MZQTBACKEND_API virtual bool inAcquisition(void);
+    MZQTBACKEND_API virtual bool refreshScanCount(void);
+    MZQTBACKEND_API virtual void saveState(ConversionCheckpoint &checkpoint) const;
+    MZQTBACKEND_API virtual void restoreState(
+        const ConversionCheckpoint &checkpoint);
+    MZQTBACKEND_API virtual UVScan* getUVScan(void);
+    MZQTBACKEND_API void getChromatogram(long chroTrace, QVector<double> &times,
                                      QVector<double> &intensities);
+    //! \brief chromatogram of every SRM transition of the file, read in a
+    //! single pass without building Scan objects
+    MZQTBACKEND_API void buildSrmChromatograms(SrmChromatogramBuilder &builder);
   };
 
 }
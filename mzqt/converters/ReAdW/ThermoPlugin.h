@@ -0,0 +1,46 @@
+/*
+ ThermoPlugin.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_THERMOPLUGIN_H_
+#define MZQT_THERMOPLUGIN_H_
+
+#include <QObject>
+
+#include "InstrumentInterfacePlugin.h"
+
+namespace mzqt {
+
+  //! ThermoInterface backend: Xcalibur .raw files
+  class ThermoPlugin: public QObject, public InstrumentInterfacePlugin {
+
+  Q_OBJECT
+  Q_PLUGIN_METADATA(IID MZQT_INSTRUMENTINTERFACEPLUGIN_IID)
+  Q_INTERFACES(mzqt::InstrumentInterfacePlugin)
+
+  public:
+    virtual QString name() const;
+    virtual bool canRead(const QString &fileName) const;
+    virtual InstrumentInterface *create();
+  };
+
+}
+
+#endif /* MZQT_THERMOPLUGIN_H_ */
@@ -212,6 +212,22 @@ void XRawfile::GetLastSpectrumNumber(int &lastScanNumber)
   lastScanNumber = args.value(0).toInt();
 }
 
+void XRawfile::InAcquisition(int &inAcquisition)
+{
+  QList<QVariant> args;
+  args << QVariant(QVariant::Int);
+
+  idispatch_->dynamicCall("InAcquisition(int &)", args);
+  checkForError("InAcquisition(int &)");
+  inAcquisition = args.value(0).toInt();
+}
+
+void XRawfile::RefreshViewOfFile()
+{
+  idispatch_->dynamicCall("RefreshViewOfFile()");
+  checkForError("RefreshViewOfFile()");
+}
+
 void XRawfile::GetNumberOfControllersOfType(int controllerType, int &number)
 {
   QList<QVariant> args;
@@ -538,6 +554,16 @@ void XRawfile::GetMassListFromScanNum(int &scanNumber, const QString &szFilter,
               centroidResult, centroidPeakWidth, masses, intensities);
 }
 
+void XRawfile::GetMassListRangeFromScanNum(int &scanNumber,
+    const QString &szFilter, int intensityCutoffType, int intensityCutoffValue,
+    int maxNumberOfPeaks, bool centroidResult, double &centroidPeakWidth,
+    const QString &massRange, QList<double> &masses, QList<double> &intensities)
+{
+  getMassList("GetMassListRangeFromScanNum", scanNumber, szFilter,
+              intensityCutoffType, intensityCutoffValue, maxNumberOfPeaks,
+              centroidResult, centroidPeakWidth, masses, intensities, massRange);
+}
+
 void XRawfile::GetPrevMassListFromScanNum(int &scanNumber,
     const QString &szFilter, int intensityCutoffType, int intensityCutoffValue,
     int maxNumberOfPeaks, bool centroidResult, double &centroidPeakWidth,
@@ -551,7 +577,7 @@ void XRawfile::GetPrevMassListFromScanNum(int &scanNumber,
 void XRawfile::getMassList(const char *methodName, int &scanNumber,
     const QString &szFilter, int intensityCutoffType, int intensityCutoffValue,
     int maxNumberOfPeaks, bool centroidResult, double &centroidPeakWidth,
-    QList<double> &masses, QList<double> &intensities)
+    QList<double> &masses, QList<double> &intensities, const QString &massRange)
 {
   masses.clear();
   intensities.clear();
@@ -561,11 +587,15 @@ void XRawfile::getMassList(const char *methodName, int &scanNumber,
   assert(dispid != DISPID_UNKNOWN);
 
   //init the variants
-  VARIANTARG varg[10];
-  for (int i = 0; i < 10; ++i) {
+  VARIANTARG varg[11];
+  for (int i = 0; i < 11; ++i) {
     ::VariantInit(&varg[i]);
   }
 
+  // the range versions take the mass range before the array size
+  int r = massRange.isEmpty() ? 0 : 1;
+  BSTR bstrMassRange = NULL;
+
   VARIANT varMassList;
   VariantInit(&varMassList);
   VARIANT varPeakFlags;
@@ -574,30 +604,35 @@ void XRawfile::getMassList(const char *methodName, int &scanNumber,
 
   varg[0].vt = VT_BYREF | VT_I4;
   varg[0].plVal = &nArraySize;
-  varg[1].vt = VT_BYREF | VT_VARIANT;
-  varg[1].pvarVal = &varPeakFlags;
-  varg[2].vt = VT_BYREF | VT_VARIANT;
-  varg[2].pvarVal = &varMassList;
-  varg[3].vt = VT_BYREF | VT_R8;
-  varg[3].pdblVal = &centroidPeakWidth;
-  varg[4].vt = VT_I4;
-  varg[4].lVal = (long) centroidResult;
-  varg[5].vt = VT_I4;
-  varg[5].lVal = maxNumberOfPeaks;
-  varg[6].vt = VT_I4;
-  varg[6].lVal = intensityCutoffValue;
-  varg[7].vt = VT_I4;
-  varg[7].lVal = intensityCutoffType;
-  varg[8].vt = VT_BSTR;
-  varg[8].bstrVal = NULL;
+  if (r) {
+    bstrMassRange = ::SysAllocString((const OLECHAR *) massRange.utf16());
+    varg[1].vt = VT_BSTR;
+    varg[1].bstrVal = bstrMassRange;
+  }
+  varg[r + 1].vt = VT_BYREF | VT_VARIANT;
+  varg[r + 1].pvarVal = &varPeakFlags;
+  varg[r + 2].vt = VT_BYREF | VT_VARIANT;
+  varg[r + 2].pvarVal = &varMassList;
+  varg[r + 3].vt = VT_BYREF | VT_R8;
+  varg[r + 3].pdblVal = &centroidPeakWidth;
+  varg[r + 4].vt = VT_I4;
+  varg[r + 4].lVal = (long) centroidResult;
+  varg[r + 5].vt = VT_I4;
+  varg[r + 5].lVal = maxNumberOfPeaks;
+  varg[r + 6].vt = VT_I4;
+  varg[r + 6].lVal = intensityCutoffValue;
+  varg[r + 7].vt = VT_I4;
+  varg[r + 7].lVal = intensityCutoffType;
+  varg[r + 8].vt = VT_BSTR;
+  varg[r + 8].bstrVal = NULL;
 
   long sNumber = scanNumber;
-  varg[9].vt = VT_BYREF | VT_I4;
-  varg[9].plVal = &sNumber;
+  varg[r + 9].vt = VT_BYREF | VT_I4;
+  varg[r + 9].plVal = &sNumber;
 
   //set up the parameter
   DISPPARAMS params;
-  params.cArgs = 10;
+  params.cArgs = 10 + r;
   params.rgdispidNamedArgs = 0;
   params.cNamedArgs = 0;
   params.rgvarg = varg;
@@ -615,6 +650,9 @@ void XRawfile::getMassList(const char *methodName, int &scanNumber,
                               DISPATCH_METHOD | DISPATCH_PROPERTYGET, &params,
                               &res, &excepinfo, &argerr);
 
+  if (bstrMassRange != NULL)
+    ::SysFreeString(bstrMassRange);
+
   checkForError(methodName);
 
   if (FAILED(hres))
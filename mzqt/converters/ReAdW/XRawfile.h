@@ -32,15 +32,19 @@
 
 #include "IDispatch.h"
 
-#if defined(__GNUC__) || defined(MZQT_STATIC)
-#ifndef MZQTDLL_API
-#define MZQTDLL_API
+#if defined(__GNUC__) || defined(MZQT_STATIC) || defined(MZQT_BACKEND_PLUGIN)
+#ifndef MZQTBACKEND_API
+#define MZQTBACKEND_API
 #endif
 #else
 #ifdef MZQTDLL_EXPORTS
-#define MZQTDLL_API __declspec(dllexport)
+#ifndef MZQTBACKEND_API
+#define MZQTBACKEND_API __declspec(dllexport)
+#endif
 #else
-#define MZQTDLL_API __declspec(dllimport)
+#ifndef MZQTBACKEND_API
+#define MZQTBACKEND_API __declspec(dllimport)
+#endif
 #endif
 #endif
 
@@ -60,60 +64,70 @@ namespace mzqt {
     XRawfile();
     ~XRawfile();
 
-    MZQTDLL_API bool init(const QString &component="");
-
-    MZQTDLL_API void Open(const QString &inputFileName);
-    MZQTDLL_API void GetErrorCode(int &errorCode);
-    MZQTDLL_API void GetErrorMessage(QString &errorMessage);
-
-    MZQTDLL_API void GetVersionNumber(int &versionNumber);
-    MZQTDLL_API void SetCurrentController(int controllerType, int controllerNumber);
-    MZQTDLL_API void GetFirstSpectrumNumber(int &firstScanNumber);
-    MZQTDLL_API void GetLastSpectrumNumber(int &lastScanNumber);
-    MZQTDLL_API void GetStartTime(double &startTime);
-    MZQTDLL_API void GetEndTime(double &endTime);
-    MZQTDLL_API void GetInstModel(QString &model);
-    MZQTDLL_API void GetInstName(QString &name);
-    MZQTDLL_API void GetInstSoftwareVersion(QString &version);
-    MZQTDLL_API void GetInstHardwareVersion(QString &version);
-    MZQTDLL_API void GetInstrumentDescription(QString &description);
-    MZQTDLL_API void GetInstSerialNumber(QString &serialNumber);
-    MZQTDLL_API void GetFilterForScanNum(int scanNumber, QString &filter);
-    MZQTDLL_API void GetCreationDate(QDateTime &date);
-    MZQTDLL_API void GetScanHeaderInfoForScanNum(int scanNumber, int &numPackets,
+    MZQTBACKEND_API bool init(const QString &component="");
+
+    MZQTBACKEND_API void Open(const QString &inputFileName);
+    MZQTBACKEND_API void GetErrorCode(int &errorCode);
+    MZQTBACKEND_API void GetErrorMessage(QString &errorMessage);
+
+    MZQTBACKEND_API void GetVersionNumber(int &versionNumber);
+    MZQTBACKEND_API void SetCurrentController(int controllerType, int controllerNumber);
+    MZQTBACKEND_API void GetFirstSpectrumNumber(int &firstScanNumber);
+    MZQTBACKEND_API void GetLastSpectrumNumber(int &lastScanNumber);
+    MZQTBACKEND_API void InAcquisition(int &inAcquisition);
+    //! \brief make the scans written since Open() visible
+    MZQTBACKEND_API void RefreshViewOfFile();
+    MZQTBACKEND_API void GetStartTime(double &startTime);
+    MZQTBACKEND_API void GetEndTime(double &endTime);
+    MZQTBACKEND_API void GetInstModel(QString &model);
+    MZQTBACKEND_API void GetInstName(QString &name);
+    MZQTBACKEND_API void GetInstSoftwareVersion(QString &version);
+    MZQTBACKEND_API void GetInstHardwareVersion(QString &version);
+    MZQTBACKEND_API void GetInstrumentDescription(QString &description);
+    MZQTBACKEND_API void GetInstSerialNumber(QString &serialNumber);
+    MZQTBACKEND_API void GetFilterForScanNum(int scanNumber, QString &filter);
+    MZQTBACKEND_API void GetCreationDate(QDateTime &date);
+    MZQTBACKEND_API void GetScanHeaderInfoForScanNum(int scanNumber, int &numPackets,
         double &startTime, double &lowMass, double &highMass, double &tic,
         double &basePeakMass, double &basePeakIntensity, int &numChannel,
         bool &uniformTime, double &frequency);
 
-    MZQTDLL_API void GetLabelData(QList<double> &masses, QList<double> &intensities,
+    MZQTBACKEND_API void GetLabelData(QList<double> &masses, QList<double> &intensities,
         int &scanNumber);
 
-    MZQTDLL_API void GetMassListFromScanNum(int &scanNumber, const QString &szFilter,
+    MZQTBACKEND_API void GetMassListFromScanNum(int &scanNumber, const QString &szFilter,
         int intensityCutoffType, int intensityCutoffValue,
         int maxNumberOfPeaks, bool centroidResult, double &centroidPeakWidth,
         QList<double> &masses, QList<double> &intensities);
 
-    MZQTDLL_API void GetPrevMassListFromScanNum(int &scanNumber, const QString &szFilter,
+    //! \brief mass list restricted to massRange ("low-high")
+    MZQTBACKEND_API void GetMassListRangeFromScanNum(int &scanNumber,
+        const QString &szFilter, int intensityCutoffType,
+        int intensityCutoffValue, int maxNumberOfPeaks, bool centroidResult,
+        double &centroidPeakWidth, const QString &massRange,
+        QList<double> &masses, QList<double> &intensities);
+
+    MZQTBACKEND_API void GetPrevMassListFromScanNum(int &scanNumber, const QString &szFilter,
         int intensityCutoffType, int intensityCutoffValue,
         int maxNumberOfPeaks, bool centroidResult, double &centroidPeakWidth,
         QList<double> &masses, QList<double> &intensities);
 
-    MZQTDLL_API void GetMassListFromRt(double &rt, const QString &szFilter,
+    MZQTBACKEND_API void GetMassListFromRt(double &rt, const QString &szFilter,
         int intensityCutoffType, int intensityCutoffValue,
         int maxNumberOfPeaks, bool centroidResult, double &centroidPeakWidth,
         QList<double> &masses, QList<double> &intensities);
 
-    MZQTDLL_API void GetAveragedMassSpectrum(const QList<int> &scanNumbers,
+    MZQTBACKEND_API void GetAveragedMassSpectrum(const QList<int> &scanNumbers,
         bool centroidResult, QList<double> &masses, QList<double> &intensities);
 
-    MZQTDLL_API void GetTrailerExtraValueForScanNum(int nScanNumber,
+    MZQTBACKEND_API void GetTrailerExtraValueForScanNum(int nScanNumber,
         const QString &szLabel, QVariant &value);
 
-    MZQTDLL_API void GetFilters(QStringList &filters);
+    MZQTBACKEND_API void GetFilters(QStringList &filters);
 
-    MZQTDLL_API void GetNumberOfControllersOfType(int controllerType, int &number);
+    MZQTBACKEND_API void GetNumberOfControllersOfType(int controllerType, int &number);
 
-    MZQTDLL_API void GetChromatogram(long chroTrace, QVector<double> &times,
+    MZQTBACKEND_API void GetChromatogram(long chroTrace, QVector<double> &times,
                                      QVector<double> &intensities);
 
   protected:
@@ -126,7 +140,7 @@ namespace mzqt {
         const QString &szFilter, int intensityCutoffType,
         int intensityCutoffValue, int maxNumberOfPeaks, bool centroidResult,
         double &centroidPeakWidth, QList<double> &masses,
-        QList<double> &intensities);
+        QList<double> &intensities, const QString &massRange = QString());
 
     DISPID dispIDofName(const QByteArray &name, ::IDispatch *disp);
 
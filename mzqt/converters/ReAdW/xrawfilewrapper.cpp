@@ -2,6 +2,7 @@
 #include "xrawfilewrapper.h"
 
 #include <qaxtypes.h>
+#include <string>
 
 using namespace mzqt;
 
@@ -172,6 +173,33 @@ void XRawfileWrapper::GetLastSpectrumNumber(long &lastScanNumber)
   lastScanNumber = e;
 }
 
+void XRawfileWrapper::InAcquisition(long &inAcquisition)
+{
+  inAcquisition = 0;
+
+  long e;
+  HRESULT hr = iface()->InAcquisition(&e);
+
+  checkForError();
+
+  if (FAILED(hr)) {
+    throw DispatchException(hr, "InAcquisition Failed");
+  }
+
+  inAcquisition = e;
+}
+
+void XRawfileWrapper::RefreshViewOfFile()
+{
+  HRESULT hr = iface()->RefreshViewOfFile();
+
+  checkForError();
+
+  if (FAILED(hr)) {
+    throw DispatchException(hr, "RefreshViewOfFile Failed");
+  }
+}
+
 void XRawfileWrapper::GetIsolationWidthForScanNum(long scanNum, long msOrder, double &isolationWidth)
 {
   isolationWidth = 0.0;
@@ -486,6 +514,75 @@ void XRawfileWrapper::GetMassListFromScanNum(long &scanNumber, const QString &sz
   ::SysReleaseString(bstrFilter);
 }
 
+void XRawfileWrapper::GetMassListRangeFromScanNum(long &scanNumber, const QString &szFilter,
+                                                  long intensityCutoffType, long intensityCutoffValue, long maxNumberOfPeaks,
+                                                  long centroidResult, double &centroidPeakWidth, const QString &massRange,
+                                                  QVector<double> &masses, QVector<double> &intensities)
+{
+  centroidPeakWidth = 0;
+  masses.clear();
+  intensities.clear();
+
+  BSTR bstrFilter = QStringToBSTR(szFilter);
+  // "low-high", the peaks outside are not transferred
+  std::wstring szMassRange = massRange.toStdWString();
+  VARIANT varMassList;
+  // initiallize variant to VT_EMPTY
+  VariantInit(&varMassList);
+
+  VARIANT varPeakFlags; // unused
+  // initiallize variant to VT_EMPTY
+  VariantInit(&varPeakFlags);
+
+  long dataPoints = 0;
+  HRESULT hr = iface()->GetMassListRangeFromScanNum(&scanNumber, bstrFilter, intensityCutoffType,
+                                                   intensityCutoffValue, maxNumberOfPeaks, centroidResult,
+                                                   &centroidPeakWidth, &varMassList, &varPeakFlags,
+                                                   &szMassRange[0], &dataPoints);
+
+  checkForError();
+
+  if (FAILED(hr)) {
+    throw DispatchException(hr, "GetMassListRangeFromScanNum Failed");
+  }
+
+  if (dataPoints) {
+
+    int dim = varMassList.parray->rgsabound[0].cElements;
+    masses.reserve(dim);
+    intensities.reserve(dim);
+
+    SAFEARRAY *parray = varMassList.parray;
+    double *pdval = (double *) parray->pvData;
+
+    for (int inx = 0; inx < dim; inx++) {
+      double dMass = (double) pdval[((inx) * 2) + 0];
+      double dInt = (double) pdval[((inx) * 2) + 1];
+
+      masses.push_back(dMass);
+      intensities.push_back(dInt);
+    }
+  }
+
+  if (varMassList.vt != VT_EMPTY) {
+    SAFEARRAY FAR* psa = varMassList.parray;
+    varMassList.parray = NULL;
+    // Delete the SafeArray
+    SafeArrayDestroy( psa);
+  }
+
+  if (varPeakFlags.vt != VT_EMPTY) {
+    SAFEARRAY FAR* psa = varPeakFlags.parray;
+    varPeakFlags.parray = NULL;
+    // Delete the SafeArray
+    SafeArrayDestroy( psa);
+  }
+
+  VariantClear(&varPeakFlags);
+  VariantClear(&varMassList);
+  ::SysReleaseString(bstrFilter);
+}
+
 void XRawfileWrapper::GetPrevMassListFromScanNum(long &scanNumber, const QString &szFilter,
                                                  long intensityCutoffType, long intensityCutoffValue, long maxNumberOfPeaks,
                                                  long centroidResult, double &centroidPeakWidth, QVector<double> &masses,
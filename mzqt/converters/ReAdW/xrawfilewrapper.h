@@ -49,6 +49,8 @@ public:
   void SetCurrentController(long controllerType, long controllerNumber);
   void GetFirstSpectrumNumber(long &firstScanNumber);
   void GetLastSpectrumNumber(long &lastScanNumber);
+  void InAcquisition(long &inAcquisition);
+  void RefreshViewOfFile();
   void GetNumberOfControllersOfType(long controllerType, long &number);
   void GetStartTime(double &startTime);
   void GetEndTime(double &endTime);
@@ -70,6 +72,10 @@ public:
       long intensityCutoffType, long intensityCutoffValue, long maxNumberOfPeaks,
       long centroidResult, double &centroidPeakWidth, QVector<double> &masses,
       QVector<double> &intensities);
+  void GetMassListRangeFromScanNum(long &scanNumber, const QString &szFilter,
+      long intensityCutoffType, long intensityCutoffValue, long maxNumberOfPeaks,
+      long centroidResult, double &centroidPeakWidth, const QString &massRange,
+      QVector<double> &masses, QVector<double> &intensities);
   void GetPrevMassListFromScanNum(long &scanNumber, const QString &szFilter,
       long intensityCutoffType, long intensityCutoffValue, long maxNumberOfPeaks,
       long centroidResult, double &centroidPeakWidth, QVector<double> &masses,
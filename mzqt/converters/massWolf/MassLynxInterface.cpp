@@ -39,6 +39,7 @@
 #include "Debug.h"
 #include "Scan.h"
 #include "UVScan.h"
+#include "ScanVisitor.h"
 #include "MSUtilities.h"
 
 #include "DACProcessInfo.h"
@@ -187,6 +188,7 @@ void MassLynxInterface::preprocessMSFunctions()
   DACScanStats scanStats;
 
   maxFunctionScan_ = 0;
+  progress_.start(PROGRESS_PREPROCESSING, totalNumScans_);
 
   for (int curFunction = 0; curFunction < (int) functionTypes_.size(); curFunction++) {
 
@@ -331,9 +333,10 @@ void MassLynxInterface::preprocessMSFunctions()
 
         scanHeaderVec_.push_back(tempScanHeader);
 
-
-
-        emit scanPreprocessed();
+        // a signal per scan costs more than the scan statistics: it is
+        // only emitted with the progress reports
+        if (progress_.advance())
+          emit scanPreprocessed();
       }
 
       //get the scan time ratio from the time range
@@ -378,6 +381,8 @@ void MassLynxInterface::preprocessMSFunctions()
     }
   }
 
+  progress_.finish();
+
   if (totalNumScans_ != (int) scanHeaderVec_.size()) {
     QString msg = QString("total Number of scan mismatch: %1 %2"
       "").arg(totalNumScans_).arg(scanHeaderVec_.size());
@@ -415,6 +420,8 @@ void MassLynxInterface::preprocessUVFunctions()
   DACFunctionInfo functionInfo;
   DACScanStats scanStats;
 
+  progress_.start(PROGRESS_PREPROCESSING, totalNumUVScans_);
+
   for (int curFunction = 0; curFunction < (int) functionTypes_.size(); curFunction++) {
 
     if (functionTypes_[curFunction] == SCAN_UV) {
@@ -467,7 +474,8 @@ void MassLynxInterface::preprocessUVFunctions()
 
         uvScanHeaderVec_.push_back(scanHeader);
 
-        emit scanPreprocessed();
+        if (progress_.advance())
+          emit scanPreprocessed();
       }
 
       if (verbose_) {
@@ -476,6 +484,8 @@ void MassLynxInterface::preprocessUVFunctions()
     }
   }
 
+  progress_.finish();
+
   if (totalNumUVScans_ != (int) uvScanHeaderVec_.size()) {
     QString msg = QString("total Number of UV scan mismatch: %1 %2"
       "").arg(totalNumUVScans_).arg(uvScanHeaderVec_.size());
@@ -499,6 +509,7 @@ bool MassLynxInterface::setInputFile(const QString & inputFileName)
     throw MassLynxInterfaceException(QString("file \"%1\" is not a directory"
       "").arg(inputFileName).toStdString());
 
+  detachPeakLoaders();
   inputFileName_ = inputFileName;
 
   // Determine number of acquired functions
@@ -651,30 +662,152 @@ void MassLynxInterface::setVerbose(bool verbose)
   verbose_ = verbose;
 }
 
-Scan* MassLynxInterface::getScan(void)
+bool MassLynxInterface::nextIndex()
 {
-  if (!firstTime_) {
+  if (!firstTime_)
     ++curScanNum_;
-    if (curScanNum_ > lastScanNumber_) {
-      // we're done
-      return NULL;
-    }
-  }
   else {
     firstTime_ = false;
+    progress_.start(PROGRESS_READING, (long) scanHeaderVec_.size()
+        - curScanNum_);
   }
 
+  // curScanNum_ is an index in scanHeaderVec_
+  if (curScanNum_ < 0)
+    return false;
+
+  // the selection is tested on the header table, the functions are not in
+  // time order: every scan is looked at
+  for (; curScanNum_ < (long) scanHeaderVec_.size(); ++curScanNum_) {
+    progress_.advance();
+    const MassLynxScanHeader &header = scanHeaderVec_[curScanNum_];
+    // without selection the skipped scans are returned empty, which keeps
+    // the numbering; a selection leaves them out like the scans it rejects
+    if (selection_.isEmpty())
+      return true;
+    if (!header.skip && selection_.acceptsMSLevel(header.msLevel)
+        && selection_.acceptsRetentionTime(header.retentionTimeInSec)
+        && selection_.acceptsMZRange(header.lowMass, header.highMass))
+      return true;
+  }
+
+  // we're done
+  progress_.finish();
+  return false;
+}
+
+Scan* MassLynxInterface::getScan(void)
+{
+  if (!nextIndex())
+    return NULL;
+
+  return readScan(curScanNum_, !selection_.isEmpty());
+}
+
+long MassLynxInterface::visitScans(ScanVisitor &visitor)
+{
+  double minMZ = -1, maxMZ = -1;
+  if (selection_.hasMZRange()) {
+    minMZ = selection_.minMZ();
+    maxMZ = selection_.maxMZ();
+  }
+
+  // reused for all the scans
+  ScanHeader header;
+  std::vector<float> massArray, intensityArray;
+  std::vector<double> masses, intensities;
+  long numScans = 0;
+
+  while (nextIndex()) {
+    if (scanHeaderVec_[curScanNum_].skip)
+      continue;
+
+    // header fields only, on the stack: no peak arrays are allocated
+    Scan scan;
+    readHeader(scan, curScanNum_);
+    header.assign(scan);
+    numScans++;
+    if (!visitor.onHeader(header))
+      continue;
+
+    // DACSpectrum gives floats: converted into the reused buffers
+    masses.clear();
+    intensities.clear();
+    if (fetchPeaks(curScanNum_, massArray, intensityArray)) {
+      for (size_t i = 0; i < massArray.size(); ++i) {
+        if (maxMZ > 0 && (massArray[i] < minMZ || massArray[i] > maxMZ))
+          continue;
+        masses.push_back(massArray[i]);
+        intensities.push_back(intensityArray[i]);
+      }
+    }
+
+    visitor.onPeaks(Span<const double>(masses.data(), masses.size()), Span<
+        const double>(intensities.data(), intensities.size()));
+  }
+
+  return numScans;
+}
+
+Scan* MassLynxInterface::getScan(long scanNumber)
+{
+  // scan numbers start at 1
+  if (scanNumber < 1 || scanNumber > (long) scanHeaderVec_.size())
+    return NULL;
+
+  return readScan(scanNumber - 1);
+}
+
+bool MassLynxInterface::seek(long scanNumber)
+{
+  if (scanNumber < 1 || scanNumber > (long) scanHeaderVec_.size())
+    return false;
+
+  curScanNum_ = scanNumber - 1;
+  firstTime_ = true;
+
+  return true;
+}
+
+Scan* MassLynxInterface::readScan(long index, bool select)
+{
   Scan* curScan = new Scan();
+  readHeader(*curScan, index);
+  if (scanHeaderVec_[index].skip == true)
+    return curScan;
+
+  // no mass range in DACSpectrum: the peaks are trimmed once read
+  double minMZ = -1, maxMZ = -1;
+  if (select && selection_.hasMZRange()) {
+    minMZ = selection_.minMZ();
+    maxMZ = selection_.maxMZ();
+  }
+
+  if (headerOnly_) {
+    // peaks are read on first access
+    curScan->setPeakLoader(peakLoader([this, index, minMZ, maxMZ](Scan &scan) {
+      readPeaks(&scan, index, minMZ, maxMZ);
+    }));
+  }
+  else
+    readPeaks(curScan, index, minMZ, maxMZ);
+
+  return curScan;
+}
+
+void MassLynxInterface::readHeader(Scan &scan, long index)
+{
+  Scan* curScan = &scan;
   curScan->isMassLynx_ = true;
+  curScan->scanNumber_ = index + 1;
 
   // we've already stored a lot of scan info in the header:
   // copy that over to the scan object that we're building
-  MassLynxScanHeader curScanHeader = scanHeaderVec_[curScanNum_];
+  const MassLynxScanHeader &curScanHeader = scanHeaderVec_[index];
   if (curScanHeader.skip == true)
-    return curScan;
+    return;
 
   curScan->msLevel_ = curScanHeader.msLevel;
-  curScan->setNumDataPoints(curScanHeader.numPeaksInScan);
   curScan->retentionTimeInSec_ = curScanHeader.retentionTimeInSec;
   curScan->minObservedMZ_ = curScanHeader.lowMass;
   curScan->maxObservedMZ_ = curScanHeader.highMass;
@@ -710,29 +843,62 @@ Scan* MassLynxInterface::getScan(void)
     //referenceScan = pExScanStats->GetReferenceScan();
     //Debug::msg() << referenceScan << endl;
   }
+}
+
+bool MassLynxInterface::fetchPeaks(long index, std::vector<float> &massArray,
+                                   std::vector<float> &intensityArray)
+{
+  const MassLynxScanHeader &curScanHeader = scanHeaderVec_[index];
 
   // Read the m/z intensity pairs
   spectrum_.getSpectrum(inputFileName_, curScanHeader.funcNum, 0,
                         curScanHeader.scanNum);
 
-  std::vector<float> intensityArray, massArray;
-
   spectrum_.getIntensities(intensityArray);
   spectrum_.getMasses(massArray);
+  progress_.addBytes(massArray.size() * 2 * sizeof(float));
 
   // TODO: do centroiding here
 
-  unsigned int numDataPoints = curScanHeader.numPeaksInScan;
+  assert(massArray.size() == (size_t) curScanHeader.numPeaksInScan);
+  assert(intensityArray.size() == (size_t) curScanHeader.numPeaksInScan);
+
+  //the scan statistics of corrupted scans may look right: test the peaks
+  int errors = validator_.validate(massArray.data(), intensityArray.data(),
+                                   massArray.size(), curScanHeader.lowMass,
+                                   curScanHeader.highMass);
+  if (errors != SpectrumValidator::VALID) {
+    Debug::dbg(Debug::HIGH) << "skip invalid spectrum: " << index
+        << " errors: " << errors << Debug::ENDL;
+    return false;
+  }
+
+  return true;
+}
 
-  assert(massArray.size() == numDataPoints);
-  assert(intensityArray.size() == numDataPoints);
+void MassLynxInterface::readPeaks(Scan* curScan, long index, double minMZ,
+                                  double maxMZ)
+{
+  std::vector<float> intensityArray, massArray;
+  if (!fetchPeaks(index, massArray, intensityArray)) {
+    curScan->setNumDataPoints(0);
+    return;
+  }
 
+  unsigned int numDataPoints = massArray.size();
+  curScan->setNumDataPoints(numDataPoints);
   for (unsigned int c = 0; c < numDataPoints; c++) {
     curScan->mzArray_[c] = massArray[c];
     curScan->intensityArray_[c] = intensityArray[c];
   }
 
-  return curScan;
+  if (maxMZ > 0) {
+    ScanSelection window;
+    window.setMZRange(minMZ, maxMZ);
+    window.trimPeaks(*curScan);
+  }
+
+  checkScanContent(*curScan);
 }
 
 UVScan *MassLynxInterface::getUVScan(void)
@@ -30,21 +30,22 @@
 #include <QString>
 
 #include "InstrumentInterface.h"
+#include "SpectrumValidator.h"
 #include "DACSpectrum.h"
 #include "DACExScanStats.h"
 
-#if defined(__GNUC__) || defined(MZQT_STATIC)
-#ifndef MZQTDLL_API
-#define MZQTDLL_API
+#if defined(__GNUC__) || defined(MZQT_STATIC) || defined(MZQT_BACKEND_PLUGIN)
+#ifndef MZQTBACKEND_API
+#define MZQTBACKEND_API
 #endif
 #else
 #ifdef MZQTDLL_EXPORTS
-#ifndef MZQTDLL_API
-#define MZQTDLL_API __declspec(dllexport)
+#ifndef MZQTBACKEND_API
+#define MZQTBACKEND_API __declspec(dllexport)
 #endif
 #else
-#ifndef MZQTDLL_API
-#define MZQTDLL_API __declspec(dllimport)
+#ifndef MZQTBACKEND_API
+#define MZQTBACKEND_API __declspec(dllimport)
 #endif
 #endif
 #endif
@@ -53,7 +54,7 @@ namespace mzqt {
 
   struct MassLynxScanHeader {
 
-    MZQTDLL_API MassLynxScanHeader();
+    MZQTBACKEND_API MassLynxScanHeader();
 
     int funcNum;
     int scanNum;
@@ -72,8 +73,8 @@ namespace mzqt {
   class MassLynxInterfaceException: public Exception {
 
   public:
-    MZQTDLL_API explicit MassLynxInterfaceException(const std::string &msg = "");
-    MZQTDLL_API virtual ~MassLynxInterfaceException() throw ();
+    MZQTBACKEND_API explicit MassLynxInterfaceException(const std::string &msg = "");
+    MZQTBACKEND_API virtual ~MassLynxInterfaceException() throw ();
   };
 
   class MassLynxInterface: public InstrumentInterface {
@@ -81,6 +82,7 @@ namespace mzqt {
   Q_OBJECT
 
   signals:
+    // emitted with the progress reports, see setProgressCallback()
     void scanPreprocessed();
     void uvScanPreprocessed();
 
@@ -112,32 +114,46 @@ namespace mzqt {
     void preprocessMSFunctions();
     void preprocessUVFunctions();
 
+    bool nextIndex();
+    Scan* readScan(long index, bool select = false);
+    void readHeader(Scan &scan, long index);
+    //! \brief false if the spectrum is not valid
+    bool fetchPeaks(long index, std::vector<float> &massArray,
+                    std::vector<float> &intensityArray);
+    void readPeaks(Scan* curScan, long index, double minMZ, double maxMZ);
+
   public:
-    MZQTDLL_API MassLynxInterface(void);
-    MZQTDLL_API ~MassLynxInterface(void);
-
-    MZQTDLL_API virtual void initInterface(void);
-    MZQTDLL_API bool preprocessFunctions(bool uv);
-    MZQTDLL_API virtual bool setInputFile(const QString& fileName);
-    MZQTDLL_API virtual void setCentroiding(bool centroid);
-    MZQTDLL_API virtual void setDeisotoping(bool deisotope);
-    MZQTDLL_API virtual void setCompression(bool compression);
-    MZQTDLL_API virtual void setVerbose(bool verbose);
-    MZQTDLL_API virtual void setFunctionFilter(int functionNumber);
-    MZQTDLL_API virtual Scan* getScan(void);
-    MZQTDLL_API virtual UVScan *getUVScan(void);
-
-    MZQTDLL_API virtual void setShotgunFragmentation(bool /*sf*/)
+    MZQTBACKEND_API MassLynxInterface(void);
+    MZQTBACKEND_API ~MassLynxInterface(void);
+
+    MZQTBACKEND_API virtual void initInterface(void);
+    MZQTBACKEND_API bool preprocessFunctions(bool uv);
+    MZQTBACKEND_API virtual bool setInputFile(const QString& fileName);
+    MZQTBACKEND_API virtual void setCentroiding(bool centroid);
+    MZQTBACKEND_API virtual void setDeisotoping(bool deisotope);
+    MZQTBACKEND_API virtual void setCompression(bool compression);
+    MZQTBACKEND_API virtual void setVerbose(bool verbose);
+    MZQTBACKEND_API virtual void setFunctionFilter(int functionNumber);
+    MZQTBACKEND_API virtual Scan* getScan(void);
+    MZQTBACKEND_API virtual Scan* getScan(long scanNumber);
+    MZQTBACKEND_API virtual bool seek(long scanNumber);
+    MZQTBACKEND_API virtual long visitScans(ScanVisitor &visitor);
+    MZQTBACKEND_API virtual UVScan *getUVScan(void);
+
+    MZQTBACKEND_API virtual void setShotgunFragmentation(bool /*sf*/)
     {
     }
 
-    MZQTDLL_API virtual void setLockspray(bool /*ls*/)
+    MZQTBACKEND_API virtual void setLockspray(bool /*ls*/)
     {
     }
 
 
-    MZQTDLL_API const MassLynxScanHeader *getCurScanHeader();
-    MZQTDLL_API const MassLynxScanHeader *getCurUVScanHeader();
+    MZQTBACKEND_API const MassLynxScanHeader *getCurScanHeader();
+    MZQTBACKEND_API const MassLynxScanHeader *getCurUVScanHeader();
+
+    // checks the peaks read, invalid spectra are returned empty
+    SpectrumValidator validator_;
   };
 
 }
@@ -0,0 +1,48 @@
+/*
+ MassLynxPlugin.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <QFileInfo>
+
+#include "MassLynxPlugin.h"
+#include "MassLynxInterface.h"
+
+#ifdef USE_MMGR_MEMORY_CHECK
+#include <mmgr.h>
+#endif
+
+using namespace mzqt;
+
+QString MassLynxPlugin::name() const
+{
+  return "masslynx";
+}
+
+bool MassLynxPlugin::canRead(const QString &fileName) const
+{
+  QFileInfo info(fileName);
+  return info.isDir() && info.suffix().compare("raw", Qt::CaseInsensitive)
+      == 0;
+}
+
+InstrumentInterface *MassLynxPlugin::create()
+{
+  return new MassLynxInterface();
+}
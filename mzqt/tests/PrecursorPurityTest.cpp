@@ -0,0 +1,100 @@
+/*
+ PrecursorPurityTest.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <cmath>
+
+#include "PrecursorPurity.h"
+#include "SpectrumCache.h"
+#include "TestUtilities.h"
+
+using namespace mzqt;
+using namespace mzqt::test;
+
+// a z = 1 precursor at 500 with its first two isotopes, and an unrelated
+// peak isolated with it on the z = 6 grid
+static const double MZ = 500.0;
+static const double PRECURSOR = 100, ISOTOPE1 = 50, ISOTOPE2 = 20;
+static const double CONTAMINANT = 80;
+
+static const CachedSpectrum *parentSpectrum(SpectrumCache &cache)
+{
+  double mz[] = { MZ, MZ + ISOTOPE_SPACING / 6, MZ + ISOTOPE_SPACING,
+      MZ + 2 * ISOTOPE_SPACING };
+  double intensity[] = { PRECURSOR, CONTAMINANT, ISOTOPE1, ISOTOPE2 };
+  return cache.insert(1, 0, mz, intensity, 4);
+}
+
+static bool near(double a, double b)
+{
+  return std::fabs(a - b) < 1.0e-9;
+}
+
+static void testUnknownCharge()
+{
+  SpectrumCache cache;
+  const CachedSpectrum *parent = parentSpectrum(cache);
+  PrecursorPurity purity;
+
+  // the contaminant only gives a two peak envelope on the z = 6 grid
+  double total = PRECURSOR + CONTAMINANT + ISOTOPE1 + ISOTOPE2;
+  double expected = (PRECURSOR + ISOTOPE1 + ISOTOPE2) / total;
+  check(near(purity.purity(*parent, MZ, 0, 5.0), expected),
+        "unknown charge: the z = 1 envelope is used");
+}
+
+static void testKnownCharge()
+{
+  SpectrumCache cache;
+  const CachedSpectrum *parent = parentSpectrum(cache);
+  PrecursorPurity purity;
+
+  double total = PRECURSOR + CONTAMINANT + ISOTOPE1 + ISOTOPE2;
+  check(near(purity.purity(*parent, MZ, 1, 5.0),
+             (PRECURSOR + ISOTOPE1 + ISOTOPE2) / total),
+        "z = 1: the contaminant is not in the envelope");
+  check(near(purity.purity(*parent, MZ, 6, 5.0),
+             (PRECURSOR + CONTAMINANT) / total),
+        "z = 6: the envelope stops at the first missing isotope");
+}
+
+static void testWindow()
+{
+  SpectrumCache cache;
+  const CachedSpectrum *parent = parentSpectrum(cache);
+  PrecursorPurity purity;
+
+  // the second isotope is outside a 3 Th window: the envelope stops there
+  double total = PRECURSOR + CONTAMINANT + ISOTOPE1;
+  check(near(purity.purity(*parent, MZ, 1, 3.0),
+             (PRECURSOR + ISOTOPE1) / total),
+        "the envelope stops at the window");
+  check(purity.purity(*parent, MZ + 0.5, 1, 3.0) == 0,
+        "no precursor peak, no purity");
+}
+
+int main()
+{
+  testUnknownCharge();
+  testKnownCharge();
+  testWindow();
+
+  return testResult();
+}
@@ -0,0 +1,190 @@
+/*
+ ProcessPoolReaderTest.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <cstdio>
+
+#include <QCoreApplication>
+
+#include "BackendRegistry.h"
+#include "Exception.h"
+#include "ProcessPoolReader.h"
+#include "Scan.h"
+#include "ScanCodec.h"
+#include "ShmRing.h"
+#include "SyntheticInterface.h"
+#include "TestUtilities.h"
+
+using namespace mzqt;
+using namespace mzqt::test;
+
+// usage: ProcessPoolReaderTest <mzqtworker>
+
+static bool sameScan(Scan *a, Scan *b)
+{
+  return a->scanNumber_ == b->scanNumber_ && a->msLevel_ == b->msLevel_
+      && a->precursorMZ_ == b->precursorMZ_
+      && a->retentionTimeInSec_ == b->retentionTimeInSec_
+      && samePeaks(a, b);
+}
+
+static QByteArray record(long i)
+{
+  // sizes not dividing the ring size, so the records wrap at any offset
+  return QByteArray(int(i % 301), char('a' + i % 26));
+}
+
+// records of every size through a ring much smaller than their total
+static void testRingWrapAround()
+{
+  const size_t ringSize = 1000;
+  ShmRing producer(QString("mzqt-test-%1").arg(QCoreApplication::applicationPid()));
+  check(producer.create(ringSize), "ring created");
+  ShmRing consumer(producer.key());
+  check(consumer.attach(), "ring attached");
+
+  const long numRecords = 10000;
+  long pushed = 0, popped = 0;
+  size_t bytes = 0;
+  bool inOrder = true;
+  QByteArray r;
+  while (pushed < numRecords) {
+    QByteArray next = record(pushed);
+    if (producer.push(next)) {
+      bytes += next.size();
+      ++pushed;
+      continue;
+    }
+    // full: drain it
+    while (consumer.pop(r))
+      inOrder = inOrder && r == record(popped++);
+  }
+  producer.close();
+  while (consumer.pop(r))
+    inOrder = inOrder && r == record(popped++);
+
+  check(bytes > 100 * ringSize, "ring wrapped around");
+  check(popped == numRecords, "ring returned every record");
+  check(inOrder, "ring records in order and intact");
+  check(consumer.isClosed() && consumer.error().isEmpty(), "ring closed");
+}
+
+// the scans of the pool are the scans of the interface, in order
+static void testPool(const QString &worker, int numWorkers, long chunkSize)
+{
+  const size_t ringSize = 64 * 1024;
+  // the scan range is read in this process
+  SyntheticPlugin synthetic;
+  BackendRegistry registry;
+  registry.add(&synthetic);
+
+  ProcessPoolReader reader("synthetic:pool");
+  reader.setWorkerProgram(worker);
+  reader.setRegistry(&registry);
+  reader.setBackend("synthetic");
+  reader.setNumWorkers(numWorkers);
+  reader.setChunkSize(chunkSize);
+  reader.setRingSize(ringSize);
+  reader.start();
+
+  SyntheticInterface reference;
+  reference.setInputFile("synthetic:pool");
+
+  long numScans = 0;
+  size_t bytes = 0;
+  bool same = true;
+  Scan *scan;
+  while ((scan = reader.getScan()) != NULL) {
+    Scan *expected = reference.getScan();
+    if (expected == NULL || !sameScan(scan, expected))
+      same = false;
+    else
+      bytes += ScanCodec::encode(*expected).size();
+    delete expected;
+    delete scan;
+    ++numScans;
+  }
+  Scan *extra = reference.getScan();
+
+  char what[100];
+  sprintf(what, "%d workers, chunks of %ld: scans in order", numWorkers, chunkSize);
+  check(same, what);
+  sprintf(what, "%d workers, chunks of %ld: all the scans", numWorkers, chunkSize);
+  check(numScans > 0 && extra == NULL, what);
+  sprintf(what, "%d workers, chunks of %ld: rings wrapped around", numWorkers, chunkSize);
+  check(bytes > 4 * numWorkers * ringSize, what);
+  delete extra;
+}
+
+static void testScanRange(const QString &worker)
+{
+  ProcessPoolReader reader("synthetic:range");
+  reader.setWorkerProgram(worker);
+  reader.setBackend("synthetic");
+  reader.setNumWorkers(2);
+  reader.setChunkSize(7);
+  reader.setScanRange(100, 199);
+  reader.start();
+
+  long expected = 100;
+  bool inOrder = true;
+  Scan *scan;
+  while ((scan = reader.getScan()) != NULL) {
+    inOrder = inOrder && scan->scanNumber_ == expected++;
+    delete scan;
+  }
+  check(inOrder && expected == 200, "scan range read in order");
+}
+
+static void testWorkerFailure(const QString &worker)
+{
+  ProcessPoolReader reader("synthetic:failure");
+  reader.setWorkerProgram(worker);
+  reader.setBackend("no such backend");
+  reader.setScanRange(1, 10);
+  reader.start();
+  bool thrown = false;
+  try {
+    delete reader.getScan();
+  } catch (Exception &) {
+    thrown = true;
+  }
+  check(thrown, "worker failure reported");
+}
+
+int main(int argc, char *argv[])
+{
+  QCoreApplication app(argc, argv);
+  if (argc < 2) {
+    printf("usage: %s <mzqtworker>\n", argv[0]);
+    return 2;
+  }
+  QString worker = argv[1];
+
+  testRingWrapAround();
+  // one worker, chunks not dividing the run, more workers than chunks
+  testPool(worker, 1, 100);
+  testPool(worker, 3, 37);
+  testPool(worker, 8, 1);
+  testScanRange(worker);
+  testWorkerFailure(worker);
+
+  return testResult();
+}
@@ -0,0 +1,127 @@
+/*
+ TailFollowReaderTest.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "Exception.h"
+#include "Progress.h"
+#include "Scan.h"
+#include "SyntheticInterface.h"
+#include "TailFollowReader.h"
+#include "TestUtilities.h"
+
+using namespace mzqt;
+using namespace mzqt::test;
+
+// a growing run is followed to its end, scans in order and complete
+static void testFollow()
+{
+  SyntheticInterface growing;
+  growing.setNumPeaks(20);
+  growing.setNumScans(50);
+  growing.setGrowth(10, 5, 20);
+  growing.setInputFile("synthetic:follow");
+
+  SyntheticInterface reference;
+  reference.setNumPeaks(20);
+  reference.setNumScans(50);
+  reference.setInputFile("synthetic:follow");
+
+  TailFollowReader reader(growing);
+  reader.setPollInterval(5, 40);
+  long numScans = 0;
+  bool same = true;
+  Scan *scan;
+  while ((scan = reader.getScan()) != NULL) {
+    Scan *expected = reference.getScan();
+    if (expected == NULL || scan->scanNumber_ != expected->scanNumber_
+        || scan->msLevel_ != expected->msLevel_ || !samePeaks(scan, expected))
+      same = false;
+    delete expected;
+    delete scan;
+    ++numScans;
+  }
+
+  check(same, "followed scans in order");
+  check(numScans == 50, "followed all the scans");
+  check(!reader.timedOut(), "follow not timed out");
+  check(reader.polls_ > 0 && reader.emptyPolls_ > 0, "follow waited for the scans");
+}
+
+// a run growing slower than the timeout stops early
+static void testTimeout()
+{
+  SyntheticInterface growing;
+  growing.setNumScans(100);
+  growing.setGrowth(10, 1, 1000);
+  growing.setInputFile("synthetic:timeout");
+
+  TailFollowReader reader(growing);
+  reader.setPollInterval(5, 20);
+  reader.setTimeout(100);
+  long numScans = 0;
+  Scan *scan;
+  while ((scan = reader.getScan()) != NULL) {
+    delete scan;
+    ++numScans;
+  }
+
+  check(reader.timedOut(), "timed out");
+  check(numScans >= 10 && numScans < 100, "scans read before the timeout");
+}
+
+static void testCancel()
+{
+  SyntheticInterface growing;
+  growing.setNumScans(100);
+  growing.setGrowth(10, 1, 100000);
+  growing.setInputFile("synthetic:cancel");
+
+  CancellationToken token;
+  TailFollowReader reader(growing);
+  reader.setCancellationToken(&token);
+  std::thread canceller([&token] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    token.cancel();
+  });
+
+  bool aborted = false;
+  try {
+    Scan *scan;
+    while ((scan = reader.getScan()) != NULL)
+      delete scan;
+  } catch (Abort &) {
+    aborted = true;
+  }
+  canceller.join();
+  check(aborted, "follow cancelled");
+}
+
+int main()
+{
+  testFollow();
+  testTimeout();
+  testCancel();
+
+  return testResult();
+}
@@ -0,0 +1,77 @@
+/*
+ TestUtilities.h
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef MZQT_TESTUTILITIES_H_
+#define MZQT_TESTUTILITIES_H_
+
+#include <cstdio>
+#include <cstring>
+
+#include "Scan.h"
+
+namespace mzqt {
+
+  /*! Checks shared by the test programs: each test calls check() for every
+   * condition and main() returns testResult().
+   */
+  namespace test {
+
+    inline int &failures()
+    {
+      static int count = 0;
+      return count;
+    }
+
+    inline void check(bool condition, const char *what)
+    {
+      if (!condition) {
+        printf("FAILED: %s\n", what);
+        ++failures();
+      }
+    }
+
+    //! \brief exit code of the test program
+    inline int testResult()
+    {
+      if (failures() == 0)
+        printf("ok\n");
+      return failures() == 0 ? 0 : 1;
+    }
+
+    inline bool samePeaks(const Scan *a, const Scan *b)
+    {
+      int n = a->getNumDataPoints();
+      if (n != b->getNumDataPoints())
+        return false;
+      double *mzA, *mzB, *intA, *intB;
+      a->getMZArray(&mzA);
+      b->getMZArray(&mzB);
+      a->getIntensityArray(&intA);
+      b->getIntensityArray(&intB);
+      return memcmp(mzA, mzB, n * sizeof(double)) == 0
+          && memcmp(intA, intB, n * sizeof(double)) == 0;
+    }
+
+  }
+
+}
+
+#endif /* MZQT_TESTUTILITIES_H_ */
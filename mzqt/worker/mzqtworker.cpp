@@ -0,0 +1,59 @@
+/*
+ mzqtworker.cpp
+ Created on: 19/10/2026
+ Copyright (C) 2026 Molecular Discovery Ltd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// worker process of ProcessPoolReader: reads a part of a run for the parent
+
+#include <QCoreApplication>
+
+#ifdef Q_OS_WIN
+#include <objbase.h>
+#endif
+
+#include "BackendRegistry.h"
+#include "ProcessPoolReader.h"
+#include "SyntheticInterface.h"
+
+int main(int argc, char *argv[])
+{
+  QCoreApplication app(argc, argv);
+
+#ifdef Q_OS_WIN
+  // the vendor components live in the apartment of the main thread
+  CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
+#endif
+
+  int exitCode;
+  {
+    // the synthetic files of the tests and the installed plugins, unloaded
+    // before the apartment is left
+    mzqt::SyntheticPlugin synthetic;
+    mzqt::BackendRegistry registry;
+    registry.add(&synthetic);
+    registry.loadPlugins();
+    exitCode = mzqt::ProcessPoolReader::workerMain(app.arguments(),
+                                                   &registry);
+  }
+
+#ifdef Q_OS_WIN
+  CoUninitialize();
+#endif
+
+  return exitCode;
+}